@@ -0,0 +1,353 @@
+#ifndef PHOTONRPC_COROUTINE_H
+#define PHOTONRPC_COROUTINE_H
+
+#include <google/protobuf/service.h>
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// C++20 coroutine support for RpcChannel.
+//
+//   Task<int> Sum(RpcChannel* channel) {
+//     AwaitableStub<rpc::CalculateService_Stub> stub(channel);
+//     rpc::AddResponse response =
+//         co_await stub.Call(&rpc::CalculateService_Stub::Add, request);
+//     co_return response.result();
+//   }
+//
+// An awaited call suspends the coroutine instead of blocking the thread and
+// resumes it in the client event loop thread, so code after a co_await must
+// not make blocking RPC calls.
+
+template <typename T = void>
+class Task;
+
+namespace coroutine_detail {
+
+struct PromiseBase {
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<Promise> handle) noexcept {
+      PromiseBase& promise = handle.promise();
+      if (promise.continuation) {
+        return promise.continuation;
+      }
+      if (promise.detached) {
+        handle.destroy();
+      }
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  FinalAwaiter final_suspend() noexcept { return {}; }
+
+  void unhandled_exception() { exception = std::current_exception(); }
+
+  void RethrowIfFailed() {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  std::coroutine_handle<> continuation;
+  std::exception_ptr exception;
+  bool detached = false;
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+  Task<T> get_return_object();
+
+  template <typename U>
+  void return_value(U&& value) {
+    result.emplace(std::forward<U>(value));
+  }
+
+  T TakeResult() {
+    RethrowIfFailed();
+    return std::move(*result);
+  }
+
+  std::optional<T> result;
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+  Task<void> get_return_object();
+
+  void return_void() {}
+
+  void TakeResult() { RethrowIfFailed(); }
+};
+
+inline void ResumeCoroutine(void* address) {
+  std::coroutine_handle<>::from_address(address).resume();
+}
+
+}  // namespace coroutine_detail
+
+// Lazily started coroutine. It runs when awaited, or when Detach() is called
+// from non-coroutine code.
+template <typename T>
+class Task {
+ public:
+  using promise_type = coroutine_detail::Promise<T>;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+    handle_.promise().continuation = caller;
+    return handle_;
+  }
+
+  T await_resume() { return handle_.promise().TakeResult(); }
+
+  // Starts the task without anyone awaiting it. The coroutine frame frees
+  // itself when it finishes, and an exception escaping it is dropped.
+  void Detach() {
+    handle_.promise().detached = true;
+    std::exchange(handle_, {}).resume();
+  }
+
+ private:
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T>
+Task<T> coroutine_detail::Promise<T>::get_return_object() {
+  return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> coroutine_detail::Promise<void>::get_return_object() {
+  return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Awaitable form of google::protobuf::RpcChannel::CallMethod().
+class RpcCall {
+ public:
+  RpcCall(google::protobuf::RpcChannel* channel,
+          const google::protobuf::MethodDescriptor* method,
+          google::protobuf::RpcController* controller,
+          const google::protobuf::Message* request,
+          google::protobuf::Message* response)
+      : channel_(channel),
+        method_(method),
+        controller_(controller),
+        request_(request),
+        response_(response) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    channel_->CallMethod(
+        method_, controller_, request_, response_,
+        google::protobuf::NewCallback(&coroutine_detail::ResumeCoroutine,
+                                      handle.address()));
+  }
+
+  // Failures are reported through the controller, as for CallMethod().
+  void await_resume() const noexcept {}
+
+ private:
+  google::protobuf::RpcChannel* channel_;
+  const google::protobuf::MethodDescriptor* method_;
+  google::protobuf::RpcController* controller_;
+  const google::protobuf::Message* request_;
+  google::protobuf::Message* response_;
+};
+
+// Wraps a protoc generated *_Stub so that its methods can be awaited:
+//
+//   AwaitableStub<rpc::CalculateService_Stub> stub(&channel);
+//   auto response = co_await stub.Call(&rpc::CalculateService_Stub::Add, req);
+//
+// PHOTONRPC_AWAITABLE_METHOD names the methods of a subclass, which gives the
+// plain `co_await stub.Add(req)` form.
+template <typename Stub>
+class AwaitableStub {
+ public:
+  using StubType = Stub;
+
+  explicit AwaitableStub(google::protobuf::RpcChannel* channel)
+      : stub_(channel) {}
+
+  template <typename Request, typename Response>
+  Task<Response> Call(void (Stub::*method)(google::protobuf::RpcController*,
+                                           const Request*, Response*,
+                                           google::protobuf::Closure*),
+                      Request request,
+                      google::protobuf::RpcController* controller = nullptr) {
+    Response response;
+    co_await StubCall<Request, Response>{&stub_, method, controller, &request,
+                                         &response};
+    co_return response;
+  }
+
+  Stub& stub() { return stub_; }
+
+ private:
+  template <typename Request, typename Response>
+  struct StubCall {
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+      (stub->*method)(
+          controller, request, response,
+          google::protobuf::NewCallback(&coroutine_detail::ResumeCoroutine,
+                                        handle.address()));
+    }
+
+    void await_resume() const noexcept {}
+
+    Stub* stub;
+    void (Stub::*method)(google::protobuf::RpcController*, const Request*,
+                         Response*, google::protobuf::Closure*);
+    google::protobuf::RpcController* controller;
+    const Request* request;
+    Response* response;
+  };
+
+  Stub stub_;
+};
+
+#define PHOTONRPC_AWAITABLE_METHOD(NAME)                             \
+  template <typename Request>                                        \
+  auto NAME(const Request& request,                                  \
+            google::protobuf::RpcController* controller = nullptr) { \
+    return this->Call(&StubType::NAME, request, controller);         \
+  }
+
+// Runs all tasks concurrently and resumes the caller once every one of them
+// has finished, with the results in the order of `tasks`. The first
+// exception, if any, is rethrown after all tasks are done.
+template <typename T>
+Task<std::vector<T>> WhenAll(std::vector<Task<T>> tasks) {
+  struct State {
+    std::vector<std::optional<T>> results;
+    std::exception_ptr exception;
+    std::atomic<bool> failed{false};
+    // One extra count is held by the awaiter until every task is started.
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> waiter;
+  };
+
+  struct Awaiter {
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      state->waiter = handle;
+      for (size_t i = 0; i < tasks->size(); i++) {
+        Run(std::move((*tasks)[i]), state, i).Detach();
+      }
+      // False resumes the caller right away: everything already finished.
+      return --state->remaining != 0;
+    }
+
+    void await_resume() const noexcept {}
+
+    static Task<void> Run(Task<T> task, State* state, size_t index) {
+      try {
+        state->results[index].emplace(co_await std::move(task));
+      } catch (...) {
+        if (!state->failed.exchange(true)) {
+          state->exception = std::current_exception();
+        }
+      }
+      if (--state->remaining == 0) {
+        state->waiter.resume();
+      }
+    }
+
+    std::vector<Task<T>>* tasks;
+    State* state;
+  };
+
+  State state;
+  state.results.resize(tasks.size());
+  state.remaining = tasks.size() + 1;
+  co_await Awaiter{&tasks, &state};
+
+  if (state.exception) {
+    std::rethrow_exception(state.exception);
+  }
+  std::vector<T> results;
+  results.reserve(state.results.size());
+  for (auto& result : state.results) {
+    results.push_back(std::move(*result));
+  }
+  co_return results;
+}
+
+// Runs a server method as a coroutine and sends its response once the task
+// finishes:
+//
+//   void Sub(google::protobuf::RpcController* controller,
+//            const rpc::SubRequest* request, rpc::SubResponse* response,
+//            google::protobuf::Closure* done) override {
+//     CoSpawn(SubAsync(request, response), done);
+//   }
+//
+// The method returns at the first suspension point, leaving the server loop
+// free for other requests. An exception escaping the task is dropped and the
+// response is sent as it stands.
+inline void CoSpawn(Task<void> task, google::protobuf::Closure* done) {
+  auto run = [](Task<void> task,
+                google::protobuf::Closure* done) -> Task<void> {
+    try {
+      co_await std::move(task);
+    } catch (...) {
+    }
+    done->Run();
+  };
+  run(std::move(task), done).Detach();
+}
+
+// Runs a task to completion from a thread that is not a coroutine, blocking
+// that thread. Must not be called from the client event loop thread.
+template <typename T>
+T SyncWait(Task<T> task) {
+  std::promise<T> finished;
+  auto waiter = [](Task<T> task, std::promise<T>* finished) -> Task<void> {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        co_await std::move(task);
+        finished->set_value();
+      } else {
+        finished->set_value(co_await std::move(task));
+      }
+    } catch (...) {
+      finished->set_exception(std::current_exception());
+    }
+  };
+  std::future<T> result = finished.get_future();
+  waiter(std::move(task), &finished).Detach();
+  return result.get();
+}
+
+#endif  //PHOTONRPC_COROUTINE_H
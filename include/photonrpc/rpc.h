@@ -3,22 +3,113 @@
 
 #include <google/protobuf/service.h>
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class IoBuf;
+class MethodTable;
+struct FrameHeader;
+class ResponseClosure;
+class RpcClient;
+class TcpConnection;
+class TcpServer;
+class WorkStealingPool;
+
+namespace rpc {
+class RpcMessage;
+}
+
 class RpcChannel : public google::protobuf::RpcChannel {
  public:
+  // Calls made through one channel share a single long-lived connection.
+  RpcChannel();
+
+  ~RpcChannel() override;
+
+  // Blocks when `done` is null. Otherwise returns at once and runs `done` in
+  // the client event loop thread when the response arrives or the call fails.
   void CallMethod(const google::protobuf::MethodDescriptor* method,
                   google::protobuf::RpcController* controller,
                   const google::protobuf::Message* request,
                   google::protobuf::Message* response,
                   google::protobuf::Closure* done) override;
+
+ private:
+  std::unique_ptr<RpcClient> client_;
 };
 
+// Services must run `done` once the response is filled in, either before
+// returning or later from any thread (see CoSpawn() in coroutine.h); the
+// response is sent only then.
 class RpcServer {
  public:
   RpcServer();
 
+  ~RpcServer();
+
+  // Accepts connections until StopServer() or SIGINT/SIGTERM. Register the
+  // services before, nothing is dispatched to them earlier.
   void StartServer();
 
+  // Makes StartServer() return. May be called from any thread.
+  void StopServer();
+
   void ServiceRegister(google::protobuf::Service*);
+
+  // Bytes held by the buffers of all connections, see the buffer section
+  // of the config for how they are reclaimed. Any thread, until
+  // StartServer() returns.
+  int64_t buffer_bytes() const;
+
+ private:
+  // Same layout as src/core/rpc/rpc_server.h, the objects are created by the
+  // application but constructed by the library.
+  std::unique_ptr<TcpServer> tcp_server_;
+  // Runs the service methods when worker_thread_num > 0. Declared after
+  // tcp_server_ so that it is stopped while the I/O loops still exist.
+  std::unique_ptr<WorkStealingPool> worker_pool_;
+
+  void HandleRequest(const std::shared_ptr<TcpConnection>& connection,
+                     const FrameHeader& header, const IoBuf& request);
+
+  void HandleCompactRequest(const std::shared_ptr<TcpConnection>& connection,
+                            const FrameHeader& header, const IoBuf& request);
+
+  // Parses the payload of a checked request and calls method `method_id`,
+  // answering with `id` in the envelope.
+  void Dispatch(const std::shared_ptr<TcpConnection>& connection,
+                const FrameHeader& header, uint32_t id, uint32_t method_id,
+                const IoBuf& request, size_t payload_offset,
+                size_t payload_size);
+
+  // Runs the method in this thread, or in the worker pool if there is one.
+  void CallService(google::protobuf::Service* service,
+                   const google::protobuf::MethodDescriptor* method,
+                   ResponseClosure* done);
+
+  // Answers an RPC_TYPE_HANDSHAKE request with the IDs of the methods it
+  // names.
+  void HandleHandshake(const std::shared_ptr<TcpConnection>& connection,
+                       const FrameHeader& header, uint32_t id,
+                       const IoBuf& request, size_t payload_offset,
+                       size_t payload_size);
+
+  // Replies "Invalid request".
+  void SendError(const std::shared_ptr<TcpConnection>& connection,
+                 const FrameHeader& header, uint32_t id);
+
+  // Sends `payload` as a reply of `type` in the configured envelope.
+  void SendReply(const std::shared_ptr<TcpConnection>& connection,
+                 const FrameHeader& header, uint32_t id, int type,
+                 const std::string& payload);
+
+  // Stores the ID of the requested method, by name or negotiated, in
+  // `*method_id`. An empty payload is a request with only default fields.
+  bool CheckRequest(const rpc::RpcMessage& request, uint32_t* method_id);
+
+  // Built by ServiceRegister(); requests are dispatched by its method IDs.
+  std::unique_ptr<MethodTable> methods_;
 };
 
 #endif  //PHOTONRPC_RPC_H
@@ -46,11 +46,19 @@ struct TableStruct_rpc_5fmessage_2eproto {
 };
 extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_rpc_5fmessage_2eproto;
 namespace rpc {
+class HandshakeRequest;
+struct HandshakeRequestDefaultTypeInternal;
+extern HandshakeRequestDefaultTypeInternal _HandshakeRequest_default_instance_;
+class HandshakeResponse;
+struct HandshakeResponseDefaultTypeInternal;
+extern HandshakeResponseDefaultTypeInternal _HandshakeResponse_default_instance_;
 class RpcMessage;
 struct RpcMessageDefaultTypeInternal;
 extern RpcMessageDefaultTypeInternal _RpcMessage_default_instance_;
 }  // namespace rpc
 PROTOBUF_NAMESPACE_OPEN
+template<> ::rpc::HandshakeRequest* Arena::CreateMaybeMessage<::rpc::HandshakeRequest>(Arena*);
+template<> ::rpc::HandshakeResponse* Arena::CreateMaybeMessage<::rpc::HandshakeResponse>(Arena*);
 template<> ::rpc::RpcMessage* Arena::CreateMaybeMessage<::rpc::RpcMessage>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace rpc {
@@ -60,12 +68,13 @@ enum MessageType : int {
   RPC_TYPE_REQUEST = 1,
   RPC_TYPE_RESPONSE = 2,
   RPC_TYPE_ERROR = 3,
+  RPC_TYPE_HANDSHAKE = 4,
   MessageType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
   MessageType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
 };
 bool MessageType_IsValid(int value);
 constexpr MessageType MessageType_MIN = RPC_TYPE_UNKNOW;
-constexpr MessageType MessageType_MAX = RPC_TYPE_ERROR;
+constexpr MessageType MessageType_MAX = RPC_TYPE_HANDSHAKE;
 constexpr int MessageType_ARRAYSIZE = MessageType_MAX + 1;
 
 const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* MessageType_descriptor();
@@ -211,6 +220,7 @@ class RpcMessage final :
     kResponseFieldNumber = 6,
     kIdFieldNumber = 1,
     kTypeFieldNumber = 2,
+    kMethodIdFieldNumber = 7,
   };
   // string service_name = 3;
   void clear_service_name();
@@ -286,6 +296,19 @@ class RpcMessage final :
   void _internal_set_type(::rpc::MessageType value);
   public:
 
+  // optional uint32 method_id = 7;
+  bool has_method_id() const;
+  private:
+  bool _internal_has_method_id() const;
+  public:
+  void clear_method_id();
+  uint32_t method_id() const;
+  void set_method_id(uint32_t value);
+  private:
+  uint32_t _internal_method_id() const;
+  void _internal_set_method_id(uint32_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:rpc.RpcMessage)
  private:
   class _Internal;
@@ -294,12 +317,339 @@ class RpcMessage final :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr service_name_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr method_name_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr request_;
     ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr response_;
     uint32_t id_;
     int type_;
+    uint32_t method_id_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_rpc_5fmessage_2eproto;
+};
+// -------------------------------------------------------------------
+
+class HandshakeRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:rpc.HandshakeRequest) */ {
+ public:
+  inline HandshakeRequest() : HandshakeRequest(nullptr) {}
+  ~HandshakeRequest() override;
+  explicit PROTOBUF_CONSTEXPR HandshakeRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  HandshakeRequest(const HandshakeRequest& from);
+  HandshakeRequest(HandshakeRequest&& from) noexcept
+    : HandshakeRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline HandshakeRequest& operator=(const HandshakeRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline HandshakeRequest& operator=(HandshakeRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const HandshakeRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const HandshakeRequest* internal_default_instance() {
+    return reinterpret_cast<const HandshakeRequest*>(
+               &_HandshakeRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    1;
+
+  friend void swap(HandshakeRequest& a, HandshakeRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(HandshakeRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(HandshakeRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  HandshakeRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<HandshakeRequest>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const HandshakeRequest& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const HandshakeRequest& from) {
+    HandshakeRequest::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(HandshakeRequest* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "rpc.HandshakeRequest";
+  }
+  protected:
+  explicit HandshakeRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMethodNamesFieldNumber = 1,
+  };
+  // repeated string method_names = 1;
+  int method_names_size() const;
+  private:
+  int _internal_method_names_size() const;
+  public:
+  void clear_method_names();
+  const std::string& method_names(int index) const;
+  std::string* mutable_method_names(int index);
+  void set_method_names(int index, const std::string& value);
+  void set_method_names(int index, std::string&& value);
+  void set_method_names(int index, const char* value);
+  void set_method_names(int index, const char* value, size_t size);
+  std::string* add_method_names();
+  void add_method_names(const std::string& value);
+  void add_method_names(std::string&& value);
+  void add_method_names(const char* value);
+  void add_method_names(const char* value, size_t size);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>& method_names() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>* mutable_method_names();
+  private:
+  const std::string& _internal_method_names(int index) const;
+  std::string* _internal_add_method_names();
+  public:
+
+  // @@protoc_insertion_point(class_scope:rpc.HandshakeRequest)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string> method_names_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_rpc_5fmessage_2eproto;
+};
+// -------------------------------------------------------------------
+
+class HandshakeResponse final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:rpc.HandshakeResponse) */ {
+ public:
+  inline HandshakeResponse() : HandshakeResponse(nullptr) {}
+  ~HandshakeResponse() override;
+  explicit PROTOBUF_CONSTEXPR HandshakeResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  HandshakeResponse(const HandshakeResponse& from);
+  HandshakeResponse(HandshakeResponse&& from) noexcept
+    : HandshakeResponse() {
+    *this = ::std::move(from);
+  }
+
+  inline HandshakeResponse& operator=(const HandshakeResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline HandshakeResponse& operator=(HandshakeResponse&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const HandshakeResponse& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const HandshakeResponse* internal_default_instance() {
+    return reinterpret_cast<const HandshakeResponse*>(
+               &_HandshakeResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    2;
+
+  friend void swap(HandshakeResponse& a, HandshakeResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(HandshakeResponse* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(HandshakeResponse* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  HandshakeResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<HandshakeResponse>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const HandshakeResponse& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const HandshakeResponse& from) {
+    HandshakeResponse::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(HandshakeResponse* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "rpc.HandshakeResponse";
+  }
+  protected:
+  explicit HandshakeResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMethodIdsFieldNumber = 1,
+  };
+  // repeated uint32 method_ids = 1;
+  int method_ids_size() const;
+  private:
+  int _internal_method_ids_size() const;
+  public:
+  void clear_method_ids();
+  private:
+  uint32_t _internal_method_ids(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >&
+      _internal_method_ids() const;
+  void _internal_add_method_ids(uint32_t value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >*
+      _internal_mutable_method_ids();
+  public:
+  uint32_t method_ids(int index) const;
+  void set_method_ids(int index, uint32_t value);
+  void add_method_ids(uint32_t value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >&
+      method_ids() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >*
+      mutable_method_ids();
+
+  // @@protoc_insertion_point(class_scope:rpc.HandshakeResponse)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t > method_ids_;
+    mutable std::atomic<int> _method_ids_cached_byte_size_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   };
   union { Impl_ _impl_; };
@@ -556,9 +906,171 @@ inline void RpcMessage::set_allocated_response(std::string* response) {
   // @@protoc_insertion_point(field_set_allocated:rpc.RpcMessage.response)
 }
 
+// optional uint32 method_id = 7;
+inline bool RpcMessage::_internal_has_method_id() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool RpcMessage::has_method_id() const {
+  return _internal_has_method_id();
+}
+inline void RpcMessage::clear_method_id() {
+  _impl_.method_id_ = 0u;
+  _impl_._has_bits_[0] &= ~0x00000001u;
+}
+inline uint32_t RpcMessage::_internal_method_id() const {
+  return _impl_.method_id_;
+}
+inline uint32_t RpcMessage::method_id() const {
+  // @@protoc_insertion_point(field_get:rpc.RpcMessage.method_id)
+  return _internal_method_id();
+}
+inline void RpcMessage::_internal_set_method_id(uint32_t value) {
+  _impl_._has_bits_[0] |= 0x00000001u;
+  _impl_.method_id_ = value;
+}
+inline void RpcMessage::set_method_id(uint32_t value) {
+  _internal_set_method_id(value);
+  // @@protoc_insertion_point(field_set:rpc.RpcMessage.method_id)
+}
+
+// -------------------------------------------------------------------
+
+// HandshakeRequest
+
+// repeated string method_names = 1;
+inline int HandshakeRequest::_internal_method_names_size() const {
+  return _impl_.method_names_.size();
+}
+inline int HandshakeRequest::method_names_size() const {
+  return _internal_method_names_size();
+}
+inline void HandshakeRequest::clear_method_names() {
+  _impl_.method_names_.Clear();
+}
+inline std::string* HandshakeRequest::add_method_names() {
+  std::string* _s = _internal_add_method_names();
+  // @@protoc_insertion_point(field_add_mutable:rpc.HandshakeRequest.method_names)
+  return _s;
+}
+inline const std::string& HandshakeRequest::_internal_method_names(int index) const {
+  return _impl_.method_names_.Get(index);
+}
+inline const std::string& HandshakeRequest::method_names(int index) const {
+  // @@protoc_insertion_point(field_get:rpc.HandshakeRequest.method_names)
+  return _internal_method_names(index);
+}
+inline std::string* HandshakeRequest::mutable_method_names(int index) {
+  // @@protoc_insertion_point(field_mutable:rpc.HandshakeRequest.method_names)
+  return _impl_.method_names_.Mutable(index);
+}
+inline void HandshakeRequest::set_method_names(int index, const std::string& value) {
+  _impl_.method_names_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set:rpc.HandshakeRequest.method_names)
+}
+inline void HandshakeRequest::set_method_names(int index, std::string&& value) {
+  _impl_.method_names_.Mutable(index)->assign(std::move(value));
+  // @@protoc_insertion_point(field_set:rpc.HandshakeRequest.method_names)
+}
+inline void HandshakeRequest::set_method_names(int index, const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.method_names_.Mutable(index)->assign(value);
+  // @@protoc_insertion_point(field_set_char:rpc.HandshakeRequest.method_names)
+}
+inline void HandshakeRequest::set_method_names(int index, const char* value, size_t size) {
+  _impl_.method_names_.Mutable(index)->assign(
+    reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_set_pointer:rpc.HandshakeRequest.method_names)
+}
+inline std::string* HandshakeRequest::_internal_add_method_names() {
+  return _impl_.method_names_.Add();
+}
+inline void HandshakeRequest::add_method_names(const std::string& value) {
+  _impl_.method_names_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add:rpc.HandshakeRequest.method_names)
+}
+inline void HandshakeRequest::add_method_names(std::string&& value) {
+  _impl_.method_names_.Add(std::move(value));
+  // @@protoc_insertion_point(field_add:rpc.HandshakeRequest.method_names)
+}
+inline void HandshakeRequest::add_method_names(const char* value) {
+  GOOGLE_DCHECK(value != nullptr);
+  _impl_.method_names_.Add()->assign(value);
+  // @@protoc_insertion_point(field_add_char:rpc.HandshakeRequest.method_names)
+}
+inline void HandshakeRequest::add_method_names(const char* value, size_t size) {
+  _impl_.method_names_.Add()->assign(reinterpret_cast<const char*>(value), size);
+  // @@protoc_insertion_point(field_add_pointer:rpc.HandshakeRequest.method_names)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>&
+HandshakeRequest::method_names() const {
+  // @@protoc_insertion_point(field_list:rpc.HandshakeRequest.method_names)
+  return _impl_.method_names_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField<std::string>*
+HandshakeRequest::mutable_method_names() {
+  // @@protoc_insertion_point(field_mutable_list:rpc.HandshakeRequest.method_names)
+  return &_impl_.method_names_;
+}
+
+// -------------------------------------------------------------------
+
+// HandshakeResponse
+
+// repeated uint32 method_ids = 1;
+inline int HandshakeResponse::_internal_method_ids_size() const {
+  return _impl_.method_ids_.size();
+}
+inline int HandshakeResponse::method_ids_size() const {
+  return _internal_method_ids_size();
+}
+inline void HandshakeResponse::clear_method_ids() {
+  _impl_.method_ids_.Clear();
+}
+inline uint32_t HandshakeResponse::_internal_method_ids(int index) const {
+  return _impl_.method_ids_.Get(index);
+}
+inline uint32_t HandshakeResponse::method_ids(int index) const {
+  // @@protoc_insertion_point(field_get:rpc.HandshakeResponse.method_ids)
+  return _internal_method_ids(index);
+}
+inline void HandshakeResponse::set_method_ids(int index, uint32_t value) {
+  _impl_.method_ids_.Set(index, value);
+  // @@protoc_insertion_point(field_set:rpc.HandshakeResponse.method_ids)
+}
+inline void HandshakeResponse::_internal_add_method_ids(uint32_t value) {
+  _impl_.method_ids_.Add(value);
+}
+inline void HandshakeResponse::add_method_ids(uint32_t value) {
+  _internal_add_method_ids(value);
+  // @@protoc_insertion_point(field_add:rpc.HandshakeResponse.method_ids)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >&
+HandshakeResponse::_internal_method_ids() const {
+  return _impl_.method_ids_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >&
+HandshakeResponse::method_ids() const {
+  // @@protoc_insertion_point(field_list:rpc.HandshakeResponse.method_ids)
+  return _internal_method_ids();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >*
+HandshakeResponse::_internal_mutable_method_ids() {
+  return &_impl_.method_ids_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< uint32_t >*
+HandshakeResponse::mutable_method_ids() {
+  // @@protoc_insertion_point(field_mutable_list:rpc.HandshakeResponse.method_ids)
+  return _internal_mutable_method_ids();
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -11,6 +11,62 @@ class Config {
   // Public accessors for specific config
   std::string server_host() const { return GetString("server", "host"); }
   int server_port() const { return GetInt("server", "port"); }
+  int server_io_thread_num() const { return GetInt("server", "io_thread_num"); }
+  // 0 runs service methods in the I/O threads.
+  int server_worker_thread_num() const {
+    return GetInt("server", "worker_thread_num");
+  }
+  std::string server_dispatch_policy() const {
+    return GetString("server", "dispatch_policy");
+  }
+  // "reuseport": one SO_REUSEPORT listener per I/O thread.
+  bool server_reuse_port() const {
+    return GetString("server", "listen_mode") == "reuseport";
+  }
+  bool server_reuseport_cbpf() const {
+    return GetString("server", "reuseport_cbpf") == "true";
+  }
+  // Wire format of both ends: 1 (length prefix only) or 2 (24-byte header
+  // with request id and flags). Anything else means 1.
+  int server_frame_version() const {
+    return GetInt("server", "frame_version");
+  }
+  // Frames with a longer body close the connection, on both ends; 0 allows
+  // any size.
+  int server_max_frame_size() const {
+    return GetInt("server", "max_frame_size");
+  }
+  // Request envelope of both ends: "protobuf" (rpc::RpcMessage) or
+  // "compact" (fixed binary header, method by key).
+  bool server_compact_envelope() const {
+    return GetString("server", "envelope") == "compact";
+  }
+  // Clients negotiate integer method IDs once per service and connection
+  // and then send those instead of method names or keys.
+  bool server_method_handshake() const {
+    return GetString("server", "method_handshake") == "true";
+  }
+
+  // Storage of connection buffers: "heap" or "mirrored".
+  std::string buffer_backend() const { return GetString("buffer", "backend"); }
+  // Frames of at least this many bytes travel as block chains; 0 disables.
+  int buffer_chain_threshold() const {
+    return GetInt("buffer", "chain_threshold");
+  }
+  // How often idle and oversized connection buffers are shrunk; 0 never.
+  int buffer_reclaim_interval_ms() const {
+    return GetInt("buffer", "reclaim_interval_ms");
+  }
+  // A connection without I/O for this long gets its initial buffers back.
+  int buffer_idle_timeout_ms() const {
+    return GetInt("buffer", "idle_timeout_ms");
+  }
+  // Larger buffers shrink once mostly unused for a reclaim interval.
+  int buffer_high_water() const { return GetInt("buffer", "high_water"); }
+  // Output chains of at least this size go out with MSG_ZEROCOPY; 0 never.
+  int buffer_zerocopy_threshold() const {
+    return GetInt("buffer", "zerocopy_threshold");
+  }
 
   int log_level() const { return GetInt("log", "level"); }
   int log_queue_size() const { return GetInt("log", "queue_size"); }
@@ -18,6 +74,13 @@ class Config {
   std::string log_file_path() const { return GetString("log", "file_path"); }
   bool log_truncate() const { return GetString("log", "trucate") == "true"; }
 
+  // Overrides one value, e.g. in tests. Only seen by components created
+  // afterwards, and some settings are read once per process.
+  void Set(const std::string& section, const std::string& key,
+           const std::string& value) {
+    config_map_[section][key] = value;
+  }
+
  private:
   Config(const std::string& config_path = "../conf/photonrpc.xml");
 
@@ -0,0 +1,132 @@
+#ifndef PHOTONRPC_MPSC_QUEUE_H
+#define PHOTONRPC_MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+// 多生产者单消费者的无锁队列（Vyukov算法）
+// Push()可在任意线程调用，只需一次原子交换；Pop()和Empty()只能由消费者线程调用
+// 一个生产者在交换tail和链接next之间被挂起时，消费者暂时看不到它之后的元素，
+// 但不会丢失或乱序
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_) {}
+
+  ~MpscQueue() {
+    T value;
+    while (Pop(value)) {
+    }
+    delete head_;
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  // Any thread.
+  void Push(T value) {
+    Node* node = new Node();
+    node->value = std::move(value);
+    Node* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Consumer thread only. False when no completed push is visible.
+  bool Pop(T& value) {
+    Node* next = head_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    // `next` becomes the new dummy head, its value is moved out.
+    value = std::move(next->value);
+    delete head_;
+    head_ = next;
+    return true;
+  }
+
+  // Consumer thread only.
+  bool Empty() const {
+    return head_->next.load(std::memory_order_seq_cst) == nullptr;
+  }
+
+ private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    T value;
+  };
+
+  // Consumer side.
+  Node* head_;
+  // Producer side, on its own cache line.
+  alignas(64) std::atomic<Node*> tail_;
+};
+
+// 侵入式版本的链接字段，内嵌在元素对象中
+struct MpscNode {
+  std::atomic<MpscNode*> next{nullptr};
+};
+
+// 侵入式的多生产者单消费者队列，元素继承MpscNode，Push()不分配内存
+// 队列不拥有元素，元素从Push()到被Pop()取出之间必须一直有效
+template <typename T>
+class IntrusiveMpscQueue {
+ public:
+  IntrusiveMpscQueue() : head_(&stub_), tail_(&stub_) {}
+
+  IntrusiveMpscQueue(const IntrusiveMpscQueue&) = delete;
+  IntrusiveMpscQueue& operator=(const IntrusiveMpscQueue&) = delete;
+
+  // Any thread.
+  void Push(T* value) { PushNode(value); }
+
+  // Consumer thread only. nullptr when no completed push is visible.
+  T* Pop() {
+    MpscNode* head = head_;
+    MpscNode* next = head->next.load(std::memory_order_acquire);
+    if (head == &stub_) {
+      if (next == nullptr) {
+        return nullptr;
+      }
+      head_ = next;
+      head = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+      head_ = next;
+      return static_cast<T*>(head);
+    }
+    // `head` is the last node; a producer may be linking behind it.
+    if (head != tail_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    // The stub takes its place, so `head` can be handed out.
+    PushNode(&stub_);
+    next = head->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+      head_ = next;
+      return static_cast<T*>(head);
+    }
+    return nullptr;
+  }
+
+  // Consumer thread only.
+  bool Empty() const {
+    return head_ == &stub_ &&
+           stub_.next.load(std::memory_order_seq_cst) == nullptr;
+  }
+
+ private:
+  void PushNode(MpscNode* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    MpscNode* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Consumer side: the next node to hand out, or the stub.
+  MpscNode* head_;
+  MpscNode stub_;
+  // Producer side, on its own cache line.
+  alignas(64) std::atomic<MpscNode*> tail_;
+};
+
+#endif  //PHOTONRPC_MPSC_QUEUE_H
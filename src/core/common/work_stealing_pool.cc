@@ -0,0 +1,121 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+
+namespace {
+// Set in worker threads, so that Submit() can find the caller's own deque.
+thread_local WorkStealingPool* current_pool = nullptr;
+thread_local int current_index = -1;
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(int thread_num)
+    : stopped_(false), next_(0), pending_(0), idle_num_(0) {
+  for (int i = 0; i < std::max(thread_num, 1); i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  Stop();
+}
+
+void WorkStealingPool::Start() {
+  for (int i = 0; i < thread_num(); i++) {
+    threads_.emplace_back([this, i] { this->WorkerLoop(i); });
+  }
+}
+
+void WorkStealingPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    stopped_ = true;
+  }
+  idle_cond_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+}
+
+void WorkStealingPool::Submit(std::function<void()> task) {
+  bool spawned = current_pool == this;
+  int index = spawned ? current_index
+                      : static_cast<int>(next_++ % workers_.size());
+  // Counted first: a worker that sees the count but not yet the task just
+  // looks again.
+  pending_++;
+  {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    // Requests from the I/O loops must not starve behind newer ones.
+    (spawned ? worker.tasks : worker.injected).push_back(std::move(task));
+  }
+  // Pairs with the idle_num_/pending_ order in WorkerLoop(): either the
+  // worker sees the task or we see the sleeper.
+  if (idle_num_ > 0) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_cond_.notify_one();
+  }
+}
+
+void WorkStealingPool::WorkerLoop(int index) {
+  current_pool = this;
+  current_index = index;
+
+  std::function<void()> task;
+  while (true) {
+    if (PopLocal(index, task) || Steal(index, task)) {
+      pending_--;
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    if (stopped_ && pending_ == 0) {
+      break;
+    }
+    idle_num_++;
+    idle_cond_.wait(lock, [this] { return pending_ > 0 || stopped_; });
+    idle_num_--;
+  }
+
+  current_pool = nullptr;
+  current_index = -1;
+}
+
+bool WorkStealingPool::PopLocal(int index, std::function<void()>& task) {
+  Worker& worker = *workers_[index];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (!worker.tasks.empty()) {
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+  }
+  if (!worker.injected.empty()) {
+    task = std::move(worker.injected.front());
+    worker.injected.pop_front();
+    return true;
+  }
+  return false;
+}
+
+bool WorkStealingPool::Steal(int index, std::function<void()>& task) {
+  int worker_num = thread_num();
+  for (int i = 1; i < worker_num; i++) {
+    Worker& victim = *workers_[(index + i) % worker_num];
+    std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      continue;
+    }
+    std::deque<std::function<void()>>& tasks =
+        victim.injected.empty() ? victim.tasks : victim.injected;
+    if (tasks.empty()) {
+      continue;
+    }
+    task = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+  }
+  return false;
+}
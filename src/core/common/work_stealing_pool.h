@@ -0,0 +1,73 @@
+#ifndef PHOTONRPC_WORK_STEALING_POOL_H
+#define PHOTONRPC_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 工作窃取线程池，用于在I/O线程之外执行请求处理函数
+// 每个工作线程有自己的双端队列：自己从队尾取任务，空闲时从其他线程的队头窃取
+// 这样一个耗时的任务只占住一个工作线程，排在它后面的任务会被别的线程取走
+// 外部提交的任务（如I/O线程转来的请求）另有一个先进先出队列，按到达顺序执行
+class WorkStealingPool {
+ public:
+  // At least one worker is created.
+  explicit WorkStealingPool(int thread_num);
+
+  // Stops the pool, running what is still queued.
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  void Start();
+
+  // Runs the queued tasks, then joins the workers.
+  void Stop();
+
+  // Thread-safe. A task submitted by a worker goes to that worker's own
+  // deque, other submitters spread tasks over the workers' injection queues
+  // round-robin, where they run in submission order.
+  void Submit(std::function<void()> task);
+
+  int thread_num() const { return static_cast<int>(workers_.size()); }
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    // Spawned by this worker.
+    std::deque<std::function<void()>> tasks;
+    // Submitted from outside the pool, oldest first.
+    std::deque<std::function<void()>> injected;
+  };
+
+  void WorkerLoop(int index);
+
+  // The owner takes the newest task it spawned, whose data is most likely
+  // still cached, and otherwise the oldest injected one.
+  bool PopLocal(int index, std::function<void()>& task);
+
+  // Thieves take the oldest injected task, then the oldest spawned one.
+  bool Steal(int index, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  std::atomic<bool> stopped_;
+  std::atomic<unsigned> next_;
+
+  // Tasks queued but not taken yet, over all deques.
+  std::atomic<int> pending_;
+
+  // Workers with nothing to run or steal sleep here.
+  std::atomic<int> idle_num_;
+  std::mutex idle_mutex_;
+  std::condition_variable idle_cond_;
+};
+
+#endif  //PHOTONRPC_WORK_STEALING_POOL_H
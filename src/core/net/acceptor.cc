@@ -6,23 +6,36 @@
 
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <linux/filter.h>
 #include <netinet/in.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <unistd.h>
 
-Acceptor::Acceptor() {}
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+Acceptor::Acceptor(bool reuse_port) : listenfd_(-1), reuse_port_(reuse_port) {}
+
+Acceptor::~Acceptor() {
+  if (listenfd_ >= 0) {
+    close(listenfd_);
+  }
+}
 
 void Acceptor::StartListen() {
-  const char* ip = Config::GetInstance().server_host().c_str();
+  std::string ip = Config::GetInstance().server_host();
   int port = Config::GetInstance().server_port();
 
   struct sockaddr_in address;
   bzero(&address, sizeof(address));
   address.sin_family = AF_INET;
-  inet_pton(AF_INET, ip, &address.sin_addr);
+  inet_pton(AF_INET, ip.c_str(), &address.sin_addr);
   address.sin_port = htons(port);
 
-  this->listenfd_ = socket(PF_INET, SOCK_STREAM, 0);
+  this->listenfd_ =
+      socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
   if (listenfd_ < 0) {
     // LOG_ERROR("create listen_fd failure");
     return;
@@ -34,6 +47,10 @@ void Acceptor::StartListen() {
   if (setsockopt(listenfd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
     // LOG_ERROR("setsockopt failure");
   }
+  if (reuse_port_ &&
+      setsockopt(listenfd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+    // LOG_ERROR("setsockopt SO_REUSEPORT failure");
+  }
 
   int ret = bind(listenfd_, (struct sockaddr*)&address, sizeof(address));
   if (ret < 0) {
@@ -54,8 +71,8 @@ void Acceptor::StartListen() {
   listen_channel.set_handle_read([this] {
     struct sockaddr_in client_addr;
     socklen_t client_addr_len = sizeof(client_addr);
-    int connfd =
-        accept(listenfd_, (struct sockaddr*)&client_addr, &client_addr_len);
+    int connfd = accept4(listenfd_, (struct sockaddr*)&client_addr,
+                         &client_addr_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
     if (connfd < 0) {
       // LOG_ERROR("accept failure");
       return;
@@ -70,6 +87,28 @@ void Acceptor::StartListen() {
   this->start_listen_callback_(&listen_channel);
 }
 
+bool Acceptor::AttachCpuSteering(int group_size) {
+  if (group_size <= 0) {
+    return false;
+  }
+  // A = cpu; A = A % group_size; return A;
+  struct sock_filter code[] = {
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0,
+       static_cast<__u32>(SKF_AD_OFF + SKF_AD_CPU)},
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<__u32>(group_size)},
+      {BPF_RET | BPF_A, 0, 0, 0},
+  };
+  struct sock_fprog program;
+  program.len = sizeof(code) / sizeof(code[0]);
+  program.filter = code;
+  if (setsockopt(listenfd_, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program,
+                 sizeof(program)) < 0) {
+    // LOG_ERROR("attach reuseport cbpf failure");
+    return false;
+  }
+  return true;
+}
+
 void Acceptor::set_new_connection_callback(std::function<void(int)> callback) {
   new_connection_callback_ = callback;
 }
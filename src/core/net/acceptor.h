@@ -5,7 +5,16 @@
 
 class Acceptor {
  public:
-  Acceptor();
+  // With reuse_port every Acceptor binds its own SO_REUSEPORT socket to the
+  // same address and the kernel spreads incoming connections among them.
+  explicit Acceptor(bool reuse_port = false);
+
+  // Closes the listening socket, so that the address can be bound again.
+  // The loop it was added to must not poll any more.
+  ~Acceptor();
+
+  Acceptor(const Acceptor&) = delete;
+  Acceptor& operator=(const Acceptor&) = delete;
 
   void StartListen();
 
@@ -13,12 +22,20 @@ class Acceptor {
 
   void set_start_listen_callback(std::function<void(Channel*)> callback);
 
+  int listenfd() const { return listenfd_; }
+
+  // Attaches a classic BPF program to the SO_REUSEPORT group of listenfd,
+  // returning the group member whose index equals the receiving CPU modulo
+  // group_size. Call once, after every member of the group is listening.
+  bool AttachCpuSteering(int group_size);
+
  private:
   int listenfd_;
+  bool reuse_port_;
   Channel listen_channel;
 
   std::function<void(Channel*)> start_listen_callback_;
   std::function<void(int)> new_connection_callback_;
 };
 
-#endif  //PHOTONRPC_ACCEPTOR_H
\ No newline at end of file
+#endif  //PHOTONRPC_ACCEPTOR_H
@@ -1,58 +1,131 @@
 #include "buffer.h"
 
+#include "buffer_pool.h"
+
+#include <errno.h>
+#include <string.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+BufferSpans BufferSpans::Sub(size_t offset, size_t length) const {
+  BufferSpans spans;
+  if (offset < first.size()) {
+    spans.first = first.substr(offset, length);
+    spans.second = second.substr(0, length - spans.first.size());
+  } else {
+    spans.first = second.substr(offset - first.size(), length);
+  }
+  return spans;
+}
+
+void BufferSpans::CopyTo(size_t offset, size_t length, char* dest) const {
+  BufferSpans range = Sub(offset, length);
+  memcpy(dest, range.first.data(), range.first.size());
+  memcpy(dest + range.first.size(), range.second.data(), range.second.size());
+}
+
+std::string BufferSpans::ToString() const {
+  std::string data;
+  data.reserve(size());
+  data.append(first);
+  data.append(second);
+  return data;
+}
+
+Buffer::Backend Buffer::ParseBackend(const std::string& name) {
+  if (name == "mirrored") {
+    return Backend::kMirrored;
+  }
+  return Backend::kHeap;
+}
 
-Buffer::Buffer() : read_index_(0), write_index_(0), data_size_(0) {
-  buffer_ = std::make_unique<std::vector<char>>();
-  buffer_->resize(1024);
+Buffer::Buffer() : Buffer(1024) {}
+
+Buffer::Buffer(int init_size) : Buffer(init_size, Backend::kHeap) {}
+
+Buffer::Buffer(int init_size, Backend backend)
+    : read_index_(0),
+      write_index_(0),
+      data_size_(0),
+      peak_size_(0),
+      backend_(backend),
+      data_(nullptr),
+      capacity_(0) {
+  Allocate(init_size);
 }
 
-Buffer::Buffer(int init_size) : read_index_(0), write_index_(0), data_size_(0) {
-  buffer_ = std::make_unique<std::vector<char>>();
-  buffer_->resize(init_size);
+Buffer::~Buffer() {
+  Release();
 }
 
 void Buffer::WriteData(std::string& data, int size) {
-  while (size >= static_cast<int>(buffer_->size()) - data_size_) {
-    int original_size_index = buffer_->size();
-    buffer_->resize(original_size_index * 2);
-    if (write_index_ < read_index_) {
-      for (auto iter = buffer_->begin();
-           iter != buffer_->begin() + write_index_; ++iter) {
-        buffer_->at(original_size_index) = *iter;
-        original_size_index++;
-      }
-      write_index_ = original_size_index;
-    }
+  WriteData(data.data(), size);
+}
+
+void Buffer::WriteData(const char* data, int size) {
+  EnsureWritable(size);
+  struct iovec iov[2];
+  int count = WritableIovecs(iov);
+  int copied = 0;
+  for (int i = 0; i < count && copied < size; i++) {
+    int chunk = std::min(size - copied, static_cast<int>(iov[i].iov_len));
+    memcpy(iov[i].iov_base, data + copied, chunk);
+    copied += chunk;
   }
-  std::vector<char>::iterator iter = buffer_->begin() + write_index_;
-  for (int i = 0; i < size; ++i) {
-    if (iter == buffer_->end()) {
-      iter = buffer_->begin();
-    }
-    *iter = data[i];
-    ++iter;
+  CommitWrite(size);
+}
+
+char* Buffer::BeginAppend(int size) {
+  EnsureWritable(size);
+  if (data_size_ == 0) {
+    read_index_ = 0;
+    write_index_ = 0;
   }
-  data_size_ += size;
-  write_index_ = (write_index_ + size) % buffer_->size();
+  // EnsureWritable() made room for `size`, but maybe not in one piece.
+  if (ContiguousFrom(write_index_) < size) {
+    Reallocate(capacity_);
+  }
+  return data_ + write_index_;
+}
+
+char* Buffer::AppendAvailable(int* size) {
+  EnsureWritable(1);
+  // The first writable span; it ends at the end of storage or the data.
+  char* data = data_ + write_index_;
+  *size = std::min(capacity_ - data_size_, ContiguousFrom(write_index_));
+  // Not CommitWrite(): the peak counts only what Unwrite() leaves.
+  data_size_ += *size;
+  write_index_ = (write_index_ + *size) % capacity_;
+  return data;
+}
+
+void Buffer::Unwrite(int size) {
+  data_size_ -= size;
+  write_index_ = (write_index_ - size + capacity_) % capacity_;
+  peak_size_ = std::max(peak_size_, data_size_);
 }
 
 std::string Buffer::PeekData() const {
-  std::string data;
-  auto iter = buffer_->begin() + read_index_;
-  for (int i = 0; i < data_size_; ++i) {
-    if (iter == buffer_->end()) {
-      iter = buffer_->begin();
-    }
-    data.push_back(*iter);
-    ++iter;
+  return PeekSpans().ToString();
+}
+
+BufferSpans Buffer::PeekSpans() const {
+  BufferSpans spans;
+  if (data_size_ == 0) {
+    return spans;
   }
-  return data;
+  int first_size = std::min(data_size_, ContiguousFrom(read_index_));
+  spans.first = std::string_view(data_ + read_index_, first_size);
+  spans.second = std::string_view(data_, data_size_ - first_size);
+  return spans;
 }
 
 bool Buffer::RetrieveData(int size) {
   if (data_size_ >= size) {
-    read_index_ = (read_index_ + size) % buffer_->size();
+    read_index_ = (read_index_ + size) % capacity_;
     data_size_ -= size;
     return true;
   } else {
@@ -60,28 +133,71 @@ bool Buffer::RetrieveData(int size) {
   }
 }
 
-bool Buffer::ReceiveFd(int fd) {
-  std::string temp;
-  temp.resize(1024);
-  int read_size = recv(fd, temp.data(), temp.size(), 0);
-  if (read_size > 0) {
-    this->WriteData(temp, read_size);
-    return true;
-  } else {
-    return false;
+bool Buffer::ReceiveFd(int fd, int* saved_errno) {
+  char extra[kExtraReadSize];
+  int total = 0;
+  while (true) {
+    struct iovec iov[3];
+    int count = WritableIovecs(iov);
+    int writable = GetWritableSize();
+    iov[count].iov_base = extra;
+    iov[count].iov_len = sizeof(extra);
+    count++;
+
+    ssize_t read_size = readv(fd, iov, count);
+    if (read_size <= 0) {
+      if (total > 0) {
+        // The EOF or error shows up again on the next read.
+        return true;
+      }
+      if (saved_errno != nullptr) {
+        *saved_errno = read_size == 0 ? 0 : errno;
+      }
+      return false;
+    }
+
+    if (read_size <= writable) {
+      CommitWrite(read_size);
+    } else {
+      CommitWrite(writable);
+      WriteData(extra, read_size - writable);
+    }
+    total += read_size;
+
+    // A short read means the socket is drained for now.
+    if (read_size < writable + static_cast<ssize_t>(sizeof(extra))) {
+      return true;
+    }
   }
 }
 
-bool Buffer::SendFd(int fd) {
-  std::string temp = this->PeekData();
-  // this->RetrieveData(data_size_);
-  int send_size = send(fd, temp.data(), temp.size(), 0);
+bool Buffer::SendFd(int fd, int* saved_errno) {
+  if (data_size_ == 0) {
+    if (saved_errno != nullptr) {
+      *saved_errno = 0;
+    }
+    return false;
+  }
+  BufferSpans spans = PeekSpans();
+  struct iovec iov[2];
+  iov[0].iov_base = const_cast<char*>(spans.first.data());
+  iov[0].iov_len = spans.first.size();
+  iov[1].iov_base = const_cast<char*>(spans.second.data());
+  iov[1].iov_len = spans.second.size();
+
+  // writev() with flags: MSG_NOSIGNAL, a peer that went away must not kill
+  // the process.
+  struct msghdr message = {};
+  message.msg_iov = iov;
+  message.msg_iovlen = spans.contiguous() ? 1 : 2;
+  ssize_t send_size = sendmsg(fd, &message, MSG_NOSIGNAL);
   if (send_size > 0) {
-    // std::string remain_data = temp.substr(send_size);
-    // this->WriteData(remain_data, remain_data.size());
     this->RetrieveData(send_size);
     return true;
   } else {
+    if (saved_errno != nullptr) {
+      *saved_errno = send_size == 0 ? 0 : errno;
+    }
     return false;
   }
 }
@@ -89,3 +205,77 @@ bool Buffer::SendFd(int fd) {
 int Buffer::GetSize() const {
   return data_size_;
 }
+
+int Buffer::GetWritableSize() const {
+  return capacity_ - data_size_;
+}
+
+void Buffer::EnsureWritable(int size) {
+  if (capacity_ - data_size_ >= size) {
+    return;
+  }
+  int new_capacity = std::max(capacity_, 1);
+  while (new_capacity - data_size_ < size) {
+    new_capacity *= 2;
+  }
+
+  Reallocate(new_capacity);
+}
+
+void Buffer::Shrink(int capacity) {
+  capacity = std::max(capacity, data_size_);
+  if (BufferPool::StorageSize(backend_, capacity) >= capacity_) {
+    return;
+  }
+  Reallocate(capacity);
+  ResetPeak();
+}
+
+void Buffer::Reallocate(int capacity) {
+  BufferSpans spans = PeekSpans();
+  char* old_data = data_;
+  int old_capacity = capacity_;
+  Backend old_backend = backend_;
+  Allocate(capacity);
+  spans.CopyTo(0, spans.size(), data_);
+  read_index_ = 0;
+  write_index_ = data_size_ % capacity_;
+
+  BufferPool::Free(old_backend, old_data, old_capacity);
+}
+
+void Buffer::Allocate(int capacity) {
+  capacity_ = capacity;
+  data_ = BufferPool::Allocate(&backend_, &capacity_);
+}
+
+void Buffer::Release() {
+  BufferPool::Free(backend_, data_, capacity_);
+  data_ = nullptr;
+  capacity_ = 0;
+}
+
+int Buffer::WritableIovecs(struct iovec* iov) const {
+  int writable = capacity_ - data_size_;
+  if (writable == 0) {
+    return 0;
+  }
+  int first_size = std::min(writable, ContiguousFrom(write_index_));
+  iov[0].iov_base = data_ + write_index_;
+  iov[0].iov_len = first_size;
+  if (first_size == writable) {
+    return 1;
+  }
+  iov[1].iov_base = data_;
+  iov[1].iov_len = writable - first_size;
+  return 2;
+}
+
+void Buffer::CommitWrite(int size) {
+  if (size == 0) {
+    return;
+  }
+  data_size_ += size;
+  write_index_ = (write_index_ + size) % capacity_;
+  peak_size_ = std::max(peak_size_, data_size_);
+}
@@ -1,34 +1,154 @@
 #ifndef PHOTONRPC_BUFFER_H
 #define PHOTONRPC_BUFFER_H
 
-#include <memory>
-#include <vector>
+#include <sys/uio.h>
+
+#include <string>
+#include <string_view>
+
+// 环形缓冲区中一段字节的视图，最多由两段连续内存组成
+// 只有数据跨越缓冲区末尾时second才非空
+struct BufferSpans {
+  std::string_view first;
+  std::string_view second;
+
+  size_t size() const { return first.size() + second.size(); }
+
+  bool contiguous() const { return second.empty(); }
+
+  // The bytes [offset, offset + length), which must lie within this range.
+  BufferSpans Sub(size_t offset, size_t length) const;
+
+  // Copies the bytes [offset, offset + length) to `dest`.
+  void CopyTo(size_t offset, size_t length, char* dest) const;
+
+  std::string ToString() const;
+};
 
 class Buffer {
  public:
+  enum class Backend {
+    // Plain ring, the readable bytes may wrap into two spans.
+    kHeap,
+    // The same memfd pages mapped twice back to back, so every span is
+    // contiguous. The capacity is rounded up to whole pages, and each
+    // buffer costs a memfd and two mappings. Falls back to kHeap if the
+    // mapping fails.
+    kMirrored,
+  };
+
+  // "mirrored" selects kMirrored, anything else kHeap.
+  static Backend ParseBackend(const std::string& name);
+
   Buffer();
 
   Buffer(int init_size);
 
+  Buffer(int init_size, Backend backend);
+
+  ~Buffer();
+
+  Buffer(const Buffer&) = delete;
+  Buffer& operator=(const Buffer&) = delete;
+
   void WriteData(std::string& data, int size);
 
+  void WriteData(const char* data, int size);
+
+  // Contiguous writable space for `size` bytes at the end, so a frame can
+  // be serialized in place and its header filled in afterwards. The bytes
+  // become readable with EndAppend(). If the free space wraps, the
+  // buffered data first moves to the start of the storage.
+  char* BeginAppend(int size);
+
+  // Makes the first `size` bytes from BeginAppend() readable.
+  void EndAppend(int size) { CommitWrite(size); }
+
+  // Grows the ring until `size` more bytes fit. The data moves to the start
+  // of the new storage.
+  void EnsureWritable(int size);
+
+  // Appends the next contiguous piece of free space as is, for a writer
+  // that fills it in place, and returns it with its size in `*size`. A
+  // full ring grows first. Unwrite() gives back what wasn't filled; call
+  // it even with 0 once done.
+  char* AppendAvailable(int* size);
+
+  // Drops the last `size` bytes written.
+  void Unwrite(int size);
+
   std::string PeekData() const;
 
+  // The readable bytes without copying. The views stay valid until the
+  // buffer is next modified.
+  BufferSpans PeekSpans() const;
+
   // Retrieve data from read_index_ to read_index + size.
   bool RetrieveData(int size);
 
-  bool ReceiveFd(int fd);
+  // Reads with readv() into the free space of the ring plus a 64 KiB stack
+  // area, whose bytes are then appended, so one call usually drains the
+  // socket. Reads again only while every iovec was filled. Meant for
+  // non-blocking fds.
+  // Returns false on EOF or error with nothing read. If saved_errno is
+  // given it receives the errno of the failure, or 0 for EOF.
+  bool ReceiveFd(int fd, int* saved_errno = nullptr);
 
-  // Send as much data as possible.
-  bool SendFd(int fd);
+  // Sends both segments of the readable data with one sendmsg(). Same
+  // failure reporting as ReceiveFd().
+  bool SendFd(int fd, int* saved_errno = nullptr);
 
   int GetSize() const;
 
+  // Bytes that fit before the ring has to grow.
+  int GetWritableSize() const;
+
+  int GetCapacity() const { return capacity_; }
+
+  // Largest GetSize() since construction or the last ResetPeak().
+  int peak_size() const { return peak_size_; }
+
+  void ResetPeak() { peak_size_ = data_size_; }
+
+  // Moves the data into storage of `capacity` bytes, or of the data size if
+  // that is larger. Does nothing unless the buffer gets smaller.
+  void Shrink(int capacity);
+
+  // kHeap after a failed kMirrored allocation.
+  Backend backend() const { return backend_; }
+
  private:
+  static const int kExtraReadSize = 64 * 1024;
+
+  // Moves the data to the start of new storage of `capacity` bytes.
+  void Reallocate(int capacity);
+
+  // Sets data_ and capacity_ to new storage of at least `capacity` bytes,
+  // taken from the thread's BufferPool when possible.
+  void Allocate(int capacity);
+
+  // Returns the storage to the pool.
+  void Release();
+
+  // Bytes readable or writable in one piece from `index`.
+  int ContiguousFrom(int index) const {
+    return backend_ == Backend::kMirrored ? capacity_ : capacity_ - index;
+  }
+
+  // The free space as up to two iovecs, returns how many.
+  int WritableIovecs(struct iovec* iov) const;
+
+  // Marks `size` bytes written through WritableIovecs() as readable.
+  void CommitWrite(int size);
+
   int read_index_;
   int write_index_;
   int data_size_;
-  std::unique_ptr<std::vector<char>> buffer_;
+  int peak_size_;
+
+  Backend backend_;
+  char* data_;
+  int capacity_;
 };
 
 #endif  //PHOTONRPC_BUFFER_H
\ No newline at end of file
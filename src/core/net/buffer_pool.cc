@@ -0,0 +1,175 @@
+#include "buffer_pool.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace {
+// Reserves 2 * size bytes of address space and maps the same memfd pages
+// into both halves. Returns nullptr on failure.
+char* MapMirrored(int size) {
+  int fd = memfd_create("photonrpc-buffer", MFD_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+  char* area = nullptr;
+  if (ftruncate(fd, size) == 0) {
+    void* reserved = mmap(nullptr, 2 * static_cast<size_t>(size), PROT_NONE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved != MAP_FAILED) {
+      area = static_cast<char*>(reserved);
+      if (mmap(area, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+               fd, 0) == MAP_FAILED ||
+          mmap(area + size, size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(area, 2 * static_cast<size_t>(size));
+        area = nullptr;
+      }
+    }
+  }
+  // The mappings keep the pages alive.
+  close(fd);
+  return area;
+}
+
+void FreeStorage(Buffer::Backend backend, char* data, int capacity) {
+  if (backend == Buffer::Backend::kMirrored) {
+    munmap(data, 2 * static_cast<size_t>(capacity));
+  } else {
+    delete[] data;
+  }
+}
+
+// Index of the size class holding `capacity`, or -1 if it isn't pooled.
+int SizeClass(int capacity) {
+  if (capacity < BufferPool::kMinPooledSize ||
+      capacity > BufferPool::kMaxPooledSize ||
+      (capacity & (capacity - 1)) != 0) {
+    return -1;
+  }
+  return __builtin_ctz(capacity) - __builtin_ctz(BufferPool::kMinPooledSize);
+}
+
+int RoundUpPowerOfTwo(int capacity) {
+  int rounded = BufferPool::kMinPooledSize;
+  while (rounded < capacity) {
+    rounded *= 2;
+  }
+  return rounded;
+}
+
+std::atomic<int64_t> total_allocated_bytes{0};
+std::atomic<int64_t> total_pooled_bytes{0};
+
+const int kSizeClassNum =
+    __builtin_ctz(BufferPool::kMaxPooledSize) -
+    __builtin_ctz(BufferPool::kMinPooledSize) + 1;
+
+struct FreeLists {
+  ~FreeLists() {
+    for (int i = 0; i < kSizeClassNum; i++) {
+      for (char* data : blocks[i]) {
+        FreeStorage(backend, data, BufferPool::kMinPooledSize << i);
+      }
+    }
+    total_pooled_bytes -= static_cast<int64_t>(pooled_bytes);
+  }
+
+  Buffer::Backend backend;
+  std::vector<char*> blocks[kSizeClassNum];
+  size_t pooled_bytes = 0;
+};
+
+FreeLists& ThreadFreeLists(Buffer::Backend backend) {
+  thread_local FreeLists heap_lists{Buffer::Backend::kHeap};
+  thread_local FreeLists mirrored_lists{Buffer::Backend::kMirrored};
+  return backend == Buffer::Backend::kMirrored ? mirrored_lists : heap_lists;
+}
+
+char* TakePooled(Buffer::Backend backend, int capacity) {
+  int size_class = SizeClass(capacity);
+  if (size_class < 0) {
+    return nullptr;
+  }
+  FreeLists& lists = ThreadFreeLists(backend);
+  std::vector<char*>& blocks = lists.blocks[size_class];
+  if (blocks.empty()) {
+    return nullptr;
+  }
+  char* data = blocks.back();
+  blocks.pop_back();
+  lists.pooled_bytes -= capacity;
+  total_pooled_bytes -= capacity;
+  return data;
+}
+}  // namespace
+
+int BufferPool::StorageSize(Buffer::Backend backend, int capacity) {
+  if (backend == Buffer::Backend::kMirrored) {
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (capacity <= kMaxPooledSize) {
+      capacity = RoundUpPowerOfTwo(capacity);
+    }
+    // Powers of two from the page size up are whole pages already.
+    return static_cast<int>((capacity + page_size - 1) / page_size *
+                            page_size);
+  }
+  if (capacity >= kMinPooledSize && capacity <= kMaxPooledSize) {
+    return RoundUpPowerOfTwo(capacity);
+  }
+  return std::max(capacity, 1);
+}
+
+char* BufferPool::Allocate(Buffer::Backend* backend, int* capacity) {
+  if (*backend == Buffer::Backend::kMirrored) {
+    int size = StorageSize(*backend, *capacity);
+    char* data = TakePooled(*backend, size);
+    if (data == nullptr) {
+      data = MapMirrored(size);
+    }
+    if (data != nullptr) {
+      *capacity = size;
+      total_allocated_bytes += size;
+      return data;
+    }
+    *backend = Buffer::Backend::kHeap;
+  }
+
+  *capacity = StorageSize(*backend, *capacity);
+  char* data = TakePooled(*backend, *capacity);
+  if (data == nullptr) {
+    data = new char[*capacity];
+  }
+  total_allocated_bytes += *capacity;
+  return data;
+}
+
+void BufferPool::Free(Buffer::Backend backend, char* data, int capacity) {
+  total_allocated_bytes -= capacity;
+  int size_class = SizeClass(capacity);
+  if (size_class >= 0) {
+    FreeLists& lists = ThreadFreeLists(backend);
+    if (lists.pooled_bytes + capacity <= kMaxPooledBytes) {
+      lists.blocks[size_class].push_back(data);
+      lists.pooled_bytes += capacity;
+      total_pooled_bytes += capacity;
+      return;
+    }
+  }
+  FreeStorage(backend, data, capacity);
+}
+
+size_t BufferPool::PooledBytes(Buffer::Backend backend) {
+  return ThreadFreeLists(backend).pooled_bytes;
+}
+
+int64_t BufferPool::TotalAllocatedBytes() {
+  return total_allocated_bytes;
+}
+
+int64_t BufferPool::TotalPooledBytes() {
+  return total_pooled_bytes;
+}
@@ -0,0 +1,38 @@
+#ifndef PHOTONRPC_BUFFER_POOL_H
+#define PHOTONRPC_BUFFER_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "buffer.h"
+
+// Buffer存储块的线程本地缓存池，按2的幂划分容量等级
+// 连接关闭时块回到当前线程的池中，下一个连接或扩容直接复用，不再调用malloc/mmap
+// 池不加锁：块可以在别的线程归还，只是进入归还线程的池
+class BufferPool {
+ public:
+  // Smaller requests are served exactly and never pooled.
+  static constexpr int kMinPooledSize = 1024;
+  static constexpr int kMaxPooledSize = 4 * 1024 * 1024;
+  // Per thread and backend; blocks beyond it are freed.
+  static constexpr size_t kMaxPooledBytes = 16 * 1024 * 1024;
+
+  // The size Allocate() hands out for a request of `capacity` bytes.
+  static int StorageSize(Buffer::Backend backend, int capacity);
+
+  // Storage of at least `*capacity` bytes; `*capacity` receives the real
+  // size. A failed kMirrored mapping falls back to kHeap through `*backend`.
+  static char* Allocate(Buffer::Backend* backend, int* capacity);
+
+  // Takes back storage from Allocate(), with the capacity it reported.
+  static void Free(Buffer::Backend backend, char* data, int capacity);
+
+  // Bytes cached by the calling thread.
+  static size_t PooledBytes(Buffer::Backend backend);
+
+  // Process-wide: storage held by live Buffers, and cached by all pools.
+  static int64_t TotalAllocatedBytes();
+  static int64_t TotalPooledBytes();
+};
+
+#endif  //PHOTONRPC_BUFFER_POOL_H
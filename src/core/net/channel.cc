@@ -2,6 +2,7 @@
 
 Channel::Channel(const int fd, bool read_event, bool write_event) {
   event_.data.fd = fd;
+  event_.events = 0;
   if (read_event) {
     event_.events = EPOLLIN;
   }
@@ -22,10 +23,30 @@ void Channel::set_handle_write(std::function<void()> write_callback) {
   write_callback_ = write_callback;
 }
 
+void Channel::set_handle_error(std::function<bool()> error_callback) {
+  error_callback_ = error_callback;
+}
+
+void Channel::EnableWriting() {
+  event_.events |= EPOLLOUT;
+}
+
+void Channel::DisableWriting() {
+  event_.events &= ~EPOLLOUT;
+}
+
+bool Channel::IsWriting() const {
+  return event_.events & EPOLLOUT;
+}
+
 void Channel::HandleRead() {
   this->read_callback_();
 }
 
 void Channel::HandleWrite() {
   this->write_callback_();
-}
\ No newline at end of file
+}
+
+bool Channel::HandleError() {
+  return error_callback_ && this->error_callback_();
+}
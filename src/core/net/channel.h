@@ -18,15 +18,31 @@ class Channel {
 
   void set_handle_write(std::function<void()> write_callback);
 
+  // Drains the socket's error queue on EPOLLERR, e.g. MSG_ZEROCOPY
+  // completions. Returns false if the queue was empty, i.e. the socket
+  // itself failed.
+  void set_handle_error(std::function<bool()> error_callback);
+
+  // Only change the interest set; apply it with EventLoop::UpdateChannel().
+  void EnableWriting();
+
+  void DisableWriting();
+
+  bool IsWriting() const;
+
   void HandleRead();
 
   void HandleWrite();
 
+  // False without an error callback.
+  bool HandleError();
+
  private:
   epoll_event event_;
 
   std::function<void()> read_callback_;
   std::function<void()> write_callback_;
+  std::function<bool()> error_callback_;
 };
 
 #endif  //PHOTONRPC_CHANNEL_H
\ No newline at end of file
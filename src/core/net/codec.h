@@ -1,38 +1,153 @@
 #ifndef PHOTONRPC_CODEC_H
 #define PHOTONRPC_CODEC_H
 
+#include "buffer.h"
+
+#include <endian.h>
+#include <string.h>
+
+#include <cstdint>
 #include <string>
 
+// What a frame carries besides its payload. Version 1 frames only have the
+// length, so both fields are 0 there.
+struct FrameHeader {
+  uint64_t request_id = 0;
+  uint8_t flags = 0;
+};
+
+// 帧格式
+// v1: 4字节主机字节序长度 + 负载
+// v2: 24字节定长头部，全部网络字节序，各字段自然对齐
+//   0 magic(4) | 4 version(1) | 5 flags(1) | 6 header_len(2)
+//   8 request_id(8) | 16 payload_len(4) | 20 reserved(4)
+// header_len可以大于24，多出的扩展字段由旧版本跳过
 class Codec {
  public:
+  // Bytes of the v1 length prefix.
+  static constexpr int kHeaderSize = 4;
+
+  static constexpr uint32_t kMagic = 0x50525043;  // "PRPC"
+  static constexpr uint8_t kVersion2 = 2;
+  static constexpr int kHeaderSizeV2 = 24;
+  static constexpr int kMaxHeaderSize = kHeaderSizeV2;
+
+  // v2 flags.
+  static constexpr uint8_t kFlagResponse = 1 << 0;
+  static constexpr uint8_t kFlagError = 1 << 1;
+
+  // Size of the fixed header of `version`, 1 or 2.
+  static int HeaderSize(int version) {
+    return version == kVersion2 ? kHeaderSizeV2 : kHeaderSize;
+  }
+
+  // One-shot copy of the first frame in `data`; connections decode
+  // incrementally with FrameDecoder instead.
   static std::string decode(std::string data, int size);
 
   static std::string encode(std::string& data);
+
+  // Writes the length prefix of a `payload_size`-byte frame to `dest`.
+  static void EncodeHeader(int payload_size, char* dest) {
+    memcpy(dest, &payload_size, kHeaderSize);
+  }
+
+  // Writes the header of a `payload_size`-byte frame in `version` to `dest`,
+  // which holds kMaxHeaderSize bytes. Returns the header size.
+  static int EncodeFrameHeader(int version, const FrameHeader& header,
+                               int payload_size, char* dest);
+
+  // Decodes the fixed v2 header at `src`, kHeaderSizeV2 contiguous bytes
+  // with no alignment requirement.
+  // `*header_size` receives header_len. False on a wrong magic or version
+  // or a header_len below the fixed part.
+  static bool DecodeHeaderV2(const char* src, FrameHeader* header,
+                             int* header_size, uint32_t* payload_size);
+
+  // Finds the frame at the front of `data` without copying it. On success
+  // `payload` views the frame body and `frame_size` is header plus body.
+  static bool DecodeFrame(const BufferSpans& data, BufferSpans* payload,
+                          int* frame_size);
 };
 
 inline std::string Codec::decode(std::string data, int size) {
-  const int* data_size_ptr = reinterpret_cast<const int*>(data.data());
-  int data_size = data_size_ptr[0];
-  if (data_size + 4 <= size) {
-    std::string decoded_data;
-    for (int i = 4; i < data_size + 4; i++) {
-      // decoded_data.append(&data[i]);
-      decoded_data.push_back(data[i]);
-    }
-    return decoded_data;
-  } else {
+  BufferSpans spans;
+  spans.first = std::string_view(data.data(), size);
+  BufferSpans payload;
+  int frame_size;
+  if (!DecodeFrame(spans, &payload, &frame_size)) {
     return {};
   }
+  return payload.ToString();
 }
 
 inline std::string Codec::encode(std::string& data) {
-  std::string size;
-  int data_size = data.size();
-  char* data_ptr = reinterpret_cast<char*>(&data_size);
-  for (int i = 0; i < 4; i++) {
-    char byte = data_ptr[i];
-    size.append(1, byte);
-  }
-  return size + data;
+  std::string frame(kHeaderSize + data.size(), '\0');
+  EncodeHeader(static_cast<int>(data.size()), frame.data());
+  memcpy(frame.data() + kHeaderSize, data.data(), data.size());
+  return frame;
+}
+
+inline int Codec::EncodeFrameHeader(int version, const FrameHeader& header,
+                                    int payload_size, char* dest) {
+  if (version != kVersion2) {
+    EncodeHeader(payload_size, dest);
+    return kHeaderSize;
+  }
+  // Fields go through typed locals and memcpy(): `dest` may be unaligned
+  // and is char storage. Each copy still compiles to a single store.
+  uint32_t magic = htobe32(kMagic);
+  uint16_t header_size = htobe16(kHeaderSizeV2);
+  uint64_t request_id = htobe64(header.request_id);
+  uint32_t size = htobe32(static_cast<uint32_t>(payload_size));
+  uint32_t reserved = 0;
+  memcpy(dest, &magic, sizeof(magic));
+  dest[4] = static_cast<char>(kVersion2);
+  dest[5] = static_cast<char>(header.flags);
+  memcpy(dest + 6, &header_size, sizeof(header_size));
+  memcpy(dest + 8, &request_id, sizeof(request_id));
+  memcpy(dest + 16, &size, sizeof(size));
+  memcpy(dest + 20, &reserved, sizeof(reserved));
+  return kHeaderSizeV2;
+}
+
+inline bool Codec::DecodeHeaderV2(const char* src, FrameHeader* header,
+                                  int* header_size, uint32_t* payload_size) {
+  uint32_t magic;
+  memcpy(&magic, src, sizeof(magic));
+  if (be32toh(magic) != kMagic || static_cast<uint8_t>(src[4]) != kVersion2) {
+    return false;
+  }
+  uint16_t size16;
+  memcpy(&size16, src + 6, sizeof(size16));
+  *header_size = be16toh(size16);
+  if (*header_size < kHeaderSizeV2) {
+    return false;
+  }
+  uint64_t request_id;
+  uint32_t size32;
+  memcpy(&request_id, src + 8, sizeof(request_id));
+  memcpy(&size32, src + 16, sizeof(size32));
+  header->flags = static_cast<uint8_t>(src[5]);
+  header->request_id = be64toh(request_id);
+  *payload_size = be32toh(size32);
+  return true;
+}
+
+inline bool Codec::DecodeFrame(const BufferSpans& data, BufferSpans* payload,
+                               int* frame_size) {
+  if (data.size() < kHeaderSize) {
+    return false;
+  }
+  // The header may straddle the end of the ring and needn't be aligned.
+  int data_size;
+  data.CopyTo(0, kHeaderSize, reinterpret_cast<char*>(&data_size));
+  if (data_size < 0 ||
+      static_cast<size_t>(data_size) > data.size() - kHeaderSize) {
+    return false;
+  }
+  *payload = data.Sub(kHeaderSize, data_size);
+  *frame_size = kHeaderSize + data_size;
+  return true;
 }
-#endif  //PHOTONRPC_CODEC_H
\ No newline at end of file
+#endif  //PHOTONRPC_CODEC_H
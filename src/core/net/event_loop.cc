@@ -1,5 +1,6 @@
 #include "event_loop.h"
 #include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <csignal>
 #include "../common/logger.h"
@@ -11,32 +12,50 @@ EventLoop* event_loop = nullptr;
 void stop_signal_handler(int sig) {
   if (sig == SIGINT || sig == SIGTERM) {
     if (event_loop != nullptr) {
-      event_loop->WakeUp();
+      event_loop->Quit();
     }
   }
 }
 
-EventLoop::EventLoop() : stopped_(false) {
+EventLoop::EventLoop()
+    : stopped_(false),
+      thread_id_(std::this_thread::get_id()),
+      sleeping_(false),
+      buffer_bytes_(0) {
   wakeup_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
-  Channel* wakeup_channel = new Channel(wakeup_fd_, true, false);
-  wakeup_channel->set_handle_read([this] {
+  wakeup_channel_ = Channel(wakeup_fd_, true, false);
+  wakeup_channel_.set_handle_read([this] {
     uint64_t one;
     int ret = read(wakeup_fd_, &one, sizeof(one));
-    // LOG_INFO("Signal: Stoping Loop");
-    stopped_ = true;
   });
 
-  this->AddChannel(wakeup_channel);
+  this->AddChannel(&wakeup_channel_);
+}
 
-  signal(SIGINT, stop_signal_handler);
-  signal(SIGTERM, stop_signal_handler);
-  event_loop = this;
+EventLoop::~EventLoop() {
+  if (event_loop == this) {
+    event_loop = nullptr;
+  }
+  for (auto& timer : timers_) {
+    this->RemoveChannel(&timer->channel);
+    close(timer->fd);
+  }
+  this->RemoveChannel(&wakeup_channel_);
+  close(wakeup_fd_);
 }
 
 void EventLoop::Loop() {
   // LOG_INFO("EventLoop start looping");
   while (!stopped_) {
-    int ret = poller_.poll(-1);
+    // Announce the sleep before looking at the queue: a task posted after
+    // the check then sees sleeping_ and wakes us up (both are seq_cst).
+    sleeping_ = true;
+    bool has_tasks = !pending_tasks_.Empty() || !posted_tasks_.Empty();
+    if (has_tasks) {
+      sleeping_ = false;
+    }
+    int ret = poller_.poll(has_tasks ? 0 : -1);
+    sleeping_ = false;
     if (ret < 0) {
       break;
     }
@@ -47,18 +66,35 @@ void EventLoop::Loop() {
       int sockfd = result[i].data.fd;
       int event_flag = result[i].events;
       Channel* channel = poller_.get_channel_by_fd(sockfd);
+      // The channel may have been removed by an earlier event of this batch.
+      if (channel == nullptr) {
+        continue;
+      }
 
-      if (event_flag & EPOLLIN) {
+      // Zero-copy completions raise EPOLLERR too. Once they are drained
+      // only a real error is left, which comes back on the next poll.
+      if ((event_flag & EPOLLERR) && channel->HandleError()) {
+        event_flag &= ~EPOLLERR;
+      }
+      // Errors and hang-ups surface through the read handler.
+      if (event_flag & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
         channel->HandleRead();
       }
       if (event_flag & EPOLLOUT) {
         channel->HandleWrite();
       }
     }
+
+    DoPendingTasks();
   }
   // LOG_INFO("EventLoop finish looping");
 }
 
+void EventLoop::Quit() {
+  stopped_ = true;
+  WakeUp();
+}
+
 void EventLoop::AddChannel(Channel* channel) {
   poller_.RegisterChannel(channel);
 }
@@ -67,7 +103,92 @@ void EventLoop::RemoveChannel(Channel* channel) {
   poller_.RemoveChannel(channel);
 }
 
+void EventLoop::UpdateChannel(Channel* channel) {
+  poller_.UpdateChannel(channel);
+}
+
 void EventLoop::WakeUp() {
   uint64_t one = 1;
   write(wakeup_fd_, &one, sizeof(one));
-}
\ No newline at end of file
+}
+
+void EventLoop::RunInLoop(std::function<void()> task) {
+  if (IsInLoopThread()) {
+    task();
+  } else {
+    QueueInLoop(std::move(task));
+  }
+}
+
+void EventLoop::QueueInLoop(std::function<void()> task) {
+  pending_tasks_.Push(std::move(task));
+  // An awake loop checks the queue before it blocks again.
+  if (sleeping_.exchange(false)) {
+    WakeUp();
+  }
+}
+
+void EventLoop::RunInLoop(LoopTask* task) {
+  if (IsInLoopThread()) {
+    task->RunTask();
+  } else {
+    QueueInLoop(task);
+  }
+}
+
+void EventLoop::QueueInLoop(LoopTask* task) {
+  posted_tasks_.Push(task);
+  if (sleeping_.exchange(false)) {
+    WakeUp();
+  }
+}
+
+bool EventLoop::IsInLoopThread() const {
+  return thread_id_ == std::this_thread::get_id();
+}
+
+void EventLoop::RunEvery(int interval_ms, std::function<void()> callback) {
+  auto timer = std::make_unique<Timer>();
+  timer->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  timer->channel = Channel(timer->fd, true, false);
+  timer->callback = std::move(callback);
+
+  struct itimerspec spec = {};
+  spec.it_interval.tv_sec = interval_ms / 1000;
+  spec.it_interval.tv_nsec = (interval_ms % 1000) * 1000000L;
+  spec.it_value = spec.it_interval;
+  timerfd_settime(timer->fd, 0, &spec, nullptr);
+
+  Timer* raw = timer.get();
+  timer->channel.set_handle_read([raw] {
+    uint64_t expirations;
+    if (read(raw->fd, &expirations, sizeof(expirations)) > 0) {
+      raw->callback();
+    }
+  });
+  this->AddChannel(&timer->channel);
+  timers_.push_back(std::move(timer));
+}
+
+void EventLoop::HandleStopSignals() {
+  event_loop = this;
+  signal(SIGINT, stop_signal_handler);
+  signal(SIGTERM, stop_signal_handler);
+}
+
+void EventLoop::DoPendingTasks() {
+  // Whatever is left over keeps the next poll non-blocking, so a task that
+  // requeues itself can't starve I/O.
+  int budget = kMaxTasksPerIteration;
+  for (; budget > 0; budget--) {
+    LoopTask* posted = posted_tasks_.Pop();
+    if (posted == nullptr) {
+      break;
+    }
+    posted->RunTask();
+  }
+  std::function<void()> task;
+  for (; budget > 0 && pending_tasks_.Pop(task); budget--) {
+    task();
+  }
+}
@@ -1,26 +1,104 @@
 #ifndef PHOTONRPC_EVENT_LOOP_H
 #define PHOTONRPC_EVENT_LOOP_H
 
+#include "../common/mpsc_queue.h"
 #include "poller.h"
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// 可直接投递给EventLoop的任务，链接字段内嵌在对象中，投递时不分配内存
+// 投递方拥有该对象，并保证它在RunTask()执行前一直有效
+class LoopTask : public MpscNode {
+ public:
+  virtual void RunTask() = 0;
+
+ protected:
+  ~LoopTask() = default;
+};
+
 class EventLoop {
  public:
   EventLoop();
 
+  ~EventLoop();
+
   void Loop();
 
+  // Thread-safe. Stops the loop after the current iteration.
+  void Quit();
+
   void AddChannel(Channel* channel);
 
   void RemoveChannel(Channel* channel);
 
+  void UpdateChannel(Channel* channel);
+
   void WakeUp();
 
+  // Runs the task right away when called from the loop thread, otherwise
+  // queues it for the loop thread.
+  void RunInLoop(std::function<void()> task);
+
+  // Thread-safe and lock-free. Always queues the task; it runs after the
+  // current batch of events. The eventfd is written only if the loop is
+  // blocked in epoll_wait, so a burst of posts costs at most one syscall.
+  void QueueInLoop(std::function<void()> task);
+
+  // The same for a task the caller owns; posting it doesn't allocate.
+  void RunInLoop(LoopTask* task);
+
+  void QueueInLoop(LoopTask* task);
+
+  bool IsInLoopThread() const;
+
+  // Loop thread. Runs `callback` in the loop thread every `interval_ms`
+  // milliseconds for as long as the loop lives.
+  void RunEvery(int interval_ms, std::function<void()> callback);
+
+  // Bytes of connection buffer storage owned by this loop. Written by the
+  // loop thread, readable from any thread.
+  int64_t buffer_bytes() const { return buffer_bytes_; }
+
+  void AddBufferBytes(int64_t delta) { buffer_bytes_ += delta; }
+
+  // Routes SIGINT/SIGTERM to Quit() of this loop.
+  void HandleStopSignals();
+
  private:
+  static constexpr int kMaxTasksPerIteration = 1024;
+
+  void DoPendingTasks();
+
+  // A timerfd and the channel that reads it.
+  struct Timer {
+    int fd;
+    Channel channel;
+    std::function<void()> callback;
+  };
+
   Poller poller_;
 
-  bool stopped_;
+  std::atomic<bool> stopped_;
 
   int wakeup_fd_;
+  Channel wakeup_channel_;
+
+  std::thread::id thread_id_;
+
+  // Set by the loop right before it may block in epoll_wait. The first
+  // poster to clear it writes the eventfd.
+  std::atomic<bool> sleeping_;
+  MpscQueue<std::function<void()>> pending_tasks_;
+  IntrusiveMpscQueue<LoopTask> posted_tasks_;
+
+  std::vector<std::unique_ptr<Timer>> timers_;
+
+  std::atomic<int64_t> buffer_bytes_;
 };
 
-#endif  //PHOTONRPC_EVENT_LOOP_H
\ No newline at end of file
+#endif  //PHOTONRPC_EVENT_LOOP_H
@@ -0,0 +1,50 @@
+#include "event_loop_thread.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+EventLoopThread::~EventLoopThread() {
+  StopLoop();
+}
+
+EventLoop* EventLoopThread::StartLoop(int cpu) {
+  thread_ = std::thread([this, cpu] { this->ThreadFunc(cpu); });
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return loop_ != nullptr; });
+  return loop_;
+}
+
+void EventLoopThread::StopLoop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (loop_ != nullptr) {
+      loop_->Quit();
+    }
+  }
+  thread_.join();
+}
+
+void EventLoopThread::ThreadFunc(int cpu) {
+  if (cpu >= 0) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  }
+
+  EventLoop loop;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loop_ = &loop;
+  }
+  cond_.notify_one();
+
+  loop.Loop();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  loop_ = nullptr;
+}
@@ -0,0 +1,35 @@
+#ifndef PHOTONRPC_EVENT_LOOP_THREAD_H
+#define PHOTONRPC_EVENT_LOOP_THREAD_H
+
+#include "event_loop.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// 在独立线程中运行一个EventLoop
+// EventLoop在该线程内构造，保证其归属线程正确
+class EventLoopThread {
+ public:
+  EventLoopThread() = default;
+
+  ~EventLoopThread();
+
+  // Starts the thread and blocks until its loop is ready. A non-negative
+  // cpu pins the thread to that CPU.
+  EventLoop* StartLoop(int cpu = -1);
+
+  // Quits the loop and joins the thread.
+  void StopLoop();
+
+ private:
+  void ThreadFunc(int cpu);
+
+  EventLoop* loop_ = nullptr;
+  std::thread thread_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+#endif  //PHOTONRPC_EVENT_LOOP_THREAD_H
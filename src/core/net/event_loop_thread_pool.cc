@@ -0,0 +1,90 @@
+#include "event_loop_thread_pool.h"
+
+EventLoopThreadPool::DispatchPolicy EventLoopThreadPool::ParseDispatchPolicy(
+    const std::string& name) {
+  if (name == "least_connections") {
+    return DispatchPolicy::kLeastConnections;
+  }
+  return DispatchPolicy::kRoundRobin;
+}
+
+EventLoopThreadPool::EventLoopThreadPool(EventLoop* base_loop, int thread_num,
+                                         DispatchPolicy policy)
+    : base_loop_(base_loop),
+      thread_num_(thread_num > 0 ? thread_num : 0),
+      policy_(policy),
+      pin_cpus_(false),
+      connection_counts_(new std::atomic<int>[thread_num_ + 1]),
+      next_(0) {
+  for (int i = 0; i <= thread_num_; i++) {
+    connection_counts_[i] = 0;
+  }
+}
+
+EventLoopThreadPool::~EventLoopThreadPool() {
+  Stop();
+}
+
+void EventLoopThreadPool::Start() {
+  int cpu_num = static_cast<int>(std::thread::hardware_concurrency());
+  for (int i = 0; i < thread_num_; i++) {
+    int cpu = (pin_cpus_ && cpu_num > 0) ? i % cpu_num : -1;
+    threads_.push_back(std::make_unique<EventLoopThread>());
+    loops_.push_back(threads_.back()->StartLoop(cpu));
+  }
+}
+
+void EventLoopThreadPool::Stop() {
+  for (auto& thread : threads_) {
+    thread->StopLoop();
+  }
+  threads_.clear();
+  loops_.clear();
+}
+
+EventLoop* EventLoopThreadPool::GetNextLoop() {
+  if (loops_.empty()) {
+    connection_counts_[thread_num_]++;
+    return base_loop_;
+  }
+
+  int index = 0;
+  if (policy_ == DispatchPolicy::kLeastConnections) {
+    for (int i = 1; i < static_cast<int>(loops_.size()); i++) {
+      if (connection_counts_[i] < connection_counts_[index]) {
+        index = i;
+      }
+    }
+  } else {
+    index = next_;
+    next_ = (next_ + 1) % loops_.size();
+  }
+  connection_counts_[index]++;
+  return loops_[index];
+}
+
+void EventLoopThreadPool::AcquireLoop(EventLoop* loop) {
+  int index = IndexOf(loop);
+  if (index >= 0) {
+    connection_counts_[index]++;
+  }
+}
+
+void EventLoopThreadPool::ReleaseLoop(EventLoop* loop) {
+  int index = IndexOf(loop);
+  if (index >= 0) {
+    connection_counts_[index]--;
+  }
+}
+
+int EventLoopThreadPool::IndexOf(EventLoop* loop) const {
+  if (loop == base_loop_) {
+    return thread_num_;
+  }
+  for (int i = 0; i < static_cast<int>(loops_.size()); i++) {
+    if (loops_[i] == loop) {
+      return i;
+    }
+  }
+  return -1;
+}
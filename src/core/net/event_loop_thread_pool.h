@@ -0,0 +1,62 @@
+#ifndef PHOTONRPC_EVENT_LOOP_THREAD_POOL_H
+#define PHOTONRPC_EVENT_LOOP_THREAD_POOL_H
+
+#include "event_loop_thread.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 主从Reactor中的从Reactor集合
+// 主循环只负责accept，新连接按策略分发到各个I/O线程的EventLoop
+class EventLoopThreadPool {
+ public:
+  enum class DispatchPolicy { kRoundRobin, kLeastConnections };
+
+  // "least_connections" selects kLeastConnections, anything else round-robin.
+  static DispatchPolicy ParseDispatchPolicy(const std::string& name);
+
+  EventLoopThreadPool(EventLoop* base_loop, int thread_num,
+                      DispatchPolicy policy);
+
+  ~EventLoopThreadPool();
+
+  // Pins I/O thread i to CPU i (modulo the CPU count). Call before Start().
+  void set_pin_cpus(bool pin_cpus) { pin_cpus_ = pin_cpus; }
+
+  void Start();
+
+  void Stop();
+
+  // Picks the loop for a new connection. Returns the base loop when the
+  // pool has no threads. Must be paired with ReleaseLoop() on close.
+  EventLoop* GetNextLoop();
+
+  // Accounts a connection that was accepted on `loop` itself.
+  void AcquireLoop(EventLoop* loop);
+
+  void ReleaseLoop(EventLoop* loop);
+
+  // The I/O loop of thread `index`, valid after Start().
+  EventLoop* GetLoop(int index) const { return loops_[index]; }
+
+  int thread_num() const { return thread_num_; }
+
+ private:
+  int IndexOf(EventLoop* loop) const;
+
+  EventLoop* base_loop_;
+  int thread_num_;
+  DispatchPolicy policy_;
+  bool pin_cpus_;
+
+  std::vector<std::unique_ptr<EventLoopThread>> threads_;
+  std::vector<EventLoop*> loops_;
+
+  // Live connections per loop, used by kLeastConnections.
+  std::unique_ptr<std::atomic<int>[]> connection_counts_;
+  int next_;
+};
+
+#endif  //PHOTONRPC_EVENT_LOOP_THREAD_POOL_H
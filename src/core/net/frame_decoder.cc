@@ -0,0 +1,81 @@
+#include "frame_decoder.h"
+
+#include <climits>
+
+bool FrameDecoder::Decode(const BufferSpans& data,
+                          std::vector<FrameView>* frames) {
+  size_t fixed_size = Codec::HeaderSize(version_);
+  while (true) {
+    size_t available = data.size() - frame_start_;
+    if (state_ == State::kHeader) {
+      if (available < fixed_size) {
+        return true;
+      }
+      if (!DecodeHeader(data)) {
+        return false;
+      }
+      if (max_body_size_ > 0 && body_size_ > max_body_size_) {
+        return false;
+      }
+      state_ = State::kBody;
+    }
+    if (available < header_size_ || available - header_size_ < body_size_) {
+      return true;
+    }
+    frames->push_back({frame_start_ + header_size_, body_size_, header_});
+    frame_start_ += header_size_ + body_size_;
+    state_ = State::kHeader;
+  }
+}
+
+bool FrameDecoder::DecodeHeader(const BufferSpans& data) {
+  // The header may straddle the end of the ring, so it is copied out in
+  // one piece; the fields are then read with memcpy() at any alignment.
+  char fixed[Codec::kMaxHeaderSize];
+  if (version_ != Codec::kVersion2) {
+    int payload_size;
+    data.CopyTo(frame_start_, Codec::kHeaderSize, fixed);
+    memcpy(&payload_size, fixed, sizeof(payload_size));
+    if (payload_size < 0) {
+      return false;
+    }
+    header_ = FrameHeader();
+    header_size_ = Codec::kHeaderSize;
+    body_size_ = static_cast<size_t>(payload_size);
+    return true;
+  }
+  data.CopyTo(frame_start_, Codec::kHeaderSizeV2, fixed);
+  int header_size;
+  uint32_t payload_size;
+  // Sizes travel as int further up.
+  if (!Codec::DecodeHeaderV2(fixed, &header_, &header_size, &payload_size) ||
+      payload_size > INT_MAX) {
+    return false;
+  }
+  header_size_ = static_cast<size_t>(header_size);
+  body_size_ = payload_size;
+  return true;
+}
+
+size_t FrameDecoder::TakeDecoded() {
+  size_t decoded = frame_start_;
+  frame_start_ = 0;
+  return decoded;
+}
+
+void FrameDecoder::Reset() {
+  state_ = State::kHeader;
+  header_ = FrameHeader();
+  header_size_ = 0;
+  body_size_ = 0;
+  frame_start_ = 0;
+}
+
+size_t FrameDecoder::Missing(const BufferSpans& data) const {
+  size_t frame_size = Codec::HeaderSize(version_);
+  if (state_ == State::kBody) {
+    frame_size = header_size_ + body_size_;
+  }
+  size_t available = data.size() - frame_start_;
+  return available < frame_size ? frame_size - available : 0;
+}
@@ -0,0 +1,74 @@
+#ifndef PHOTONRPC_FRAME_DECODER_H
+#define PHOTONRPC_FRAME_DECODER_H
+
+#include "buffer.h"
+#include "codec.h"
+
+#include <cstddef>
+#include <vector>
+
+// A frame body as a position in the decoder's input, not a pointer: the
+// input buffer may move its data when it grows.
+struct FrameView {
+  size_t offset;
+  size_t size;
+  FrameHeader header;
+};
+
+// 每个连接一个的增量解帧状态机
+// 在多次读之间保留帧头/帧体状态：帧头只解析一次，之后只等待帧体收齐
+// 每次只扫描新到达的字节，一次取出其中所有完整的帧，不拷贝帧体
+class FrameDecoder {
+ public:
+  // Frames in Codec format `version`, 1 or 2, with bodies of at most
+  // `max_body_size` bytes; 0 allows any size.
+  explicit FrameDecoder(int version = 1, size_t max_body_size = 0)
+      : version_(version), max_body_size_(max_body_size) {}
+
+  enum class State {
+    kHeader,  // Waiting for the length prefix of the next frame.
+    kBody,    // The length is known, waiting for the rest of the body.
+  };
+
+  // Continues over `data`, the unconsumed input, whose first bytes earlier
+  // calls have seen already. Appends a view of every frame completed by the
+  // new bytes to `frames`, relative to the start of `data`. Returns false
+  // on a negative length, a body above the maximum or a bad v2 header,
+  // after which the stream can't be resynchronized. An oversized body is
+  // refused from its header, before any of it is buffered.
+  bool Decode(const BufferSpans& data, std::vector<FrameView>* frames);
+
+  // Bytes at the front of the input taken by the frames decoded so far;
+  // the caller drops them from its buffer and the positions restart at 0.
+  size_t TakeDecoded();
+
+  // Back to kHeader at the start of the input, e.g. after the caller took
+  // over the partial frame itself.
+  void Reset();
+
+  State state() const { return state_; }
+
+  // The partial frame's header, its size and body size, valid in kBody.
+  const FrameHeader& header() const { return header_; }
+  size_t header_size() const { return header_size_; }
+  size_t body_size() const { return body_size_; }
+
+  // Bytes the partial frame still needs to be complete, header included.
+  size_t Missing(const BufferSpans& data) const;
+
+ private:
+  // Reads the header at frame_start_ into the fields below.
+  bool DecodeHeader(const BufferSpans& data);
+
+  int version_;
+  size_t max_body_size_;
+  State state_ = State::kHeader;
+  FrameHeader header_;
+  size_t header_size_ = 0;
+  size_t body_size_ = 0;
+  // Start of the partial frame in the input, i.e. the end of the decoded
+  // frames.
+  size_t frame_start_ = 0;
+};
+
+#endif  //PHOTONRPC_FRAME_DECODER_H
@@ -0,0 +1,329 @@
+#include "io_buf.h"
+
+#include <string.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <new>
+
+namespace {
+// Upper bounds per syscall, which keep the iovec arrays on the stack.
+const int kMaxReadBlocks = 16;
+const int kMaxWriteIovecs = 64;
+}  // namespace
+
+IoBuf::IoBuf(const IoBuf& other) {
+  Append(other);
+}
+
+IoBuf& IoBuf::operator=(const IoBuf& other) {
+  if (this != &other) {
+    Clear();
+    Append(other);
+  }
+  return *this;
+}
+
+IoBuf::IoBuf(IoBuf&& other) noexcept
+    : segments_(std::move(other.segments_)),
+      head_(other.head_),
+      size_(other.size_) {
+  other.segments_.clear();
+  other.head_ = 0;
+  other.size_ = 0;
+}
+
+IoBuf& IoBuf::operator=(IoBuf&& other) noexcept {
+  if (this != &other) {
+    Clear();
+    segments_.swap(other.segments_);
+    head_ = other.head_;
+    size_ = other.size_;
+    other.head_ = 0;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+IoBuf::~IoBuf() {
+  Clear();
+}
+
+void IoBuf::Append(const char* data, size_t size) {
+  while (size > 0) {
+    Block* tail = WritableTail();
+    if (tail == nullptr) {
+      tail = NewBlock();
+      PushSegment({tail, tail->data, 0});
+    }
+    size_t chunk = std::min(size, tail->capacity - tail->used);
+    memcpy(tail->data + tail->used, data, chunk);
+    tail->used += chunk;
+    segments_.back().length += chunk;
+    size_ += chunk;
+    data += chunk;
+    size -= chunk;
+  }
+}
+
+void IoBuf::Append(const IoBuf& other) {
+  // By index and count: appending to ourselves grows the vector.
+  size_t end = other.segments_.size();
+  for (size_t i = other.head_; i < end; i++) {
+    Segment segment = other.segments_[i];
+    if (segment.block == nullptr) {
+      Append(segment.data, segment.length);
+    } else {
+      Ref(segment.block);
+      PushSegment(segment);
+    }
+  }
+}
+
+void IoBuf::Append(IoBuf&& other) {
+  if (this == &other) {
+    return;
+  }
+  for (size_t i = other.head_; i < other.segments_.size(); i++) {
+    PushSegment(other.segments_[i]);
+  }
+  // The references moved with the segments.
+  other.segments_.clear();
+  other.head_ = 0;
+  other.size_ = 0;
+}
+
+void IoBuf::AppendBorrowed(const char* data, size_t size) {
+  if (size > 0) {
+    PushSegment({nullptr, data, size});
+  }
+}
+
+void IoBuf::Cut(size_t size, IoBuf* out) {
+  size = std::min(size, size_);
+  while (size > 0) {
+    Segment& segment = segments_[head_];
+    if (segment.length <= size) {
+      out->PushSegment(segment);
+      size -= segment.length;
+      size_ -= segment.length;
+      head_++;
+    } else {
+      if (segment.block != nullptr) {
+        Ref(segment.block);
+      }
+      out->PushSegment({segment.block, segment.data, size});
+      segment.data += size;
+      segment.length -= size;
+      size_ -= size;
+      size = 0;
+    }
+  }
+  if (head_ == segments_.size()) {
+    segments_.clear();
+    head_ = 0;
+  }
+}
+
+void IoBuf::PopFront(size_t size) {
+  size = std::min(size, size_);
+  while (size > 0) {
+    Segment& segment = segments_[head_];
+    if (segment.length <= size) {
+      size -= segment.length;
+      size_ -= segment.length;
+      if (segment.block != nullptr) {
+        Unref(segment.block);
+      }
+      head_++;
+    } else {
+      segment.data += size;
+      segment.length -= size;
+      size_ -= size;
+      size = 0;
+    }
+  }
+  if (head_ == segments_.size()) {
+    segments_.clear();
+    head_ = 0;
+  }
+}
+
+char* IoBuf::AppendInPlace(size_t* size) {
+  Block* tail = WritableTail();
+  if (tail == nullptr) {
+    tail = NewBlock();
+    PushSegment({tail, tail->data, 0});
+  }
+  char* data = tail->data + tail->used;
+  *size = tail->capacity - tail->used;
+  tail->used = tail->capacity;
+  segments_.back().length += *size;
+  size_ += *size;
+  return data;
+}
+
+void IoBuf::TrimBack(size_t size) {
+  Segment& segment = segments_.back();
+  segment.length -= size;
+  segment.block->used -= size;
+  size_ -= size;
+  if (segment.length == 0) {
+    Unref(segment.block);
+    segments_.pop_back();
+    if (head_ == segments_.size()) {
+      segments_.clear();
+      head_ = 0;
+    }
+  }
+}
+
+void IoBuf::Clear() {
+  for (size_t i = head_; i < segments_.size(); i++) {
+    if (segments_[i].block != nullptr) {
+      Unref(segments_[i].block);
+    }
+  }
+  segments_.clear();
+  head_ = 0;
+  size_ = 0;
+}
+
+void IoBuf::CopyTo(size_t offset, size_t length, char* dest) const {
+  for (size_t i = head_; i < segments_.size() && length > 0; i++) {
+    const Segment& segment = segments_[i];
+    if (offset >= segment.length) {
+      offset -= segment.length;
+      continue;
+    }
+    size_t chunk = std::min(length, segment.length - offset);
+    memcpy(dest, segment.data + offset, chunk);
+    dest += chunk;
+    length -= chunk;
+    offset = 0;
+  }
+}
+
+std::string IoBuf::ToString() const {
+  std::string data(size_, '\0');
+  CopyTo(0, size_, data.data());
+  return data;
+}
+
+int IoBuf::ToIovecs(struct iovec* iov, int max_count) const {
+  int count = 0;
+  for (size_t i = head_; i < segments_.size() && count < max_count; i++) {
+    iov[count].iov_base = const_cast<char*>(segments_[i].data);
+    iov[count].iov_len = segments_[i].length;
+    count++;
+  }
+  return count;
+}
+
+ssize_t IoBuf::ReadFd(int fd, size_t max_size) {
+  struct iovec iov[kMaxReadBlocks + 1];
+  Block* fresh[kMaxReadBlocks];
+  int count = 0;
+  size_t planned = 0;
+
+  Block* tail = WritableTail();
+  if (tail != nullptr) {
+    size_t room = std::min(tail->capacity - tail->used, max_size);
+    iov[count].iov_base = tail->data + tail->used;
+    iov[count].iov_len = room;
+    count++;
+    planned += room;
+  }
+  int fresh_count = 0;
+  while (planned < max_size && fresh_count < kMaxReadBlocks) {
+    Block* block = NewBlock();
+    size_t room = std::min(block->capacity, max_size - planned);
+    fresh[fresh_count++] = block;
+    iov[count].iov_base = block->data;
+    iov[count].iov_len = room;
+    count++;
+    planned += room;
+  }
+
+  ssize_t read_size = readv(fd, iov, count);
+  size_t remaining = read_size > 0 ? read_size : 0;
+
+  if (tail != nullptr) {
+    size_t chunk = std::min(remaining, iov[0].iov_len);
+    tail->used += chunk;
+    segments_.back().length += chunk;
+    size_ += chunk;
+    remaining -= chunk;
+  }
+  for (int i = 0; i < fresh_count; i++) {
+    size_t chunk = std::min(remaining, fresh[i]->capacity);
+    if (chunk == 0) {
+      Unref(fresh[i]);
+      continue;
+    }
+    fresh[i]->used = chunk;
+    PushSegment({fresh[i], fresh[i]->data, chunk});
+    remaining -= chunk;
+  }
+  return read_size;
+}
+
+ssize_t IoBuf::WriteFd(int fd, int flags, IoBuf* sent) {
+  struct iovec iov[kMaxWriteIovecs];
+  struct msghdr message = {};
+  message.msg_iov = iov;
+  message.msg_iovlen = ToIovecs(iov, kMaxWriteIovecs);
+  ssize_t send_size = sendmsg(fd, &message, MSG_NOSIGNAL | flags);
+  if (send_size > 0) {
+    if (sent != nullptr) {
+      Cut(send_size, sent);
+    } else {
+      PopFront(send_size);
+    }
+  }
+  return send_size;
+}
+
+IoBuf::Block* IoBuf::NewBlock() {
+  void* memory = ::operator new(sizeof(Block) + kBlockSize);
+  Block* block = new (memory) Block;
+  block->refs = 1;
+  block->capacity = kBlockSize;
+  block->used = 0;
+  return block;
+}
+
+void IoBuf::Ref(Block* block) {
+  block->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IoBuf::Unref(Block* block) {
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    block->~Block();
+    ::operator delete(block);
+  }
+}
+
+IoBuf::Block* IoBuf::WritableTail() const {
+  if (segment_count() == 0) {
+    return nullptr;
+  }
+  const Segment& last = segments_.back();
+  Block* block = last.block;
+  // Shared blocks stay immutable: another holder may append behind `used`.
+  if (block == nullptr || block->refs.load(std::memory_order_acquire) != 1 ||
+      last.data + last.length != block->data + block->used ||
+      block->used == block->capacity) {
+    return nullptr;
+  }
+  return block;
+}
+
+void IoBuf::PushSegment(const Segment& segment) {
+  if (head_ > 0 && head_ == segments_.size()) {
+    segments_.clear();
+    head_ = 0;
+  }
+  segments_.push_back(segment);
+  size_ += segment.length;
+}
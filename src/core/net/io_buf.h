@@ -0,0 +1,121 @@
+#ifndef PHOTONRPC_IO_BUF_H
+#define PHOTONRPC_IO_BUF_H
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 由引用计数的定长内存块组成的链式缓冲区
+// Cut()/Append(IoBuf)只移动或共享内存块，不拷贝数据，适合在各层之间传递大消息
+// 也可以借用外部内存（AppendBorrowed），用于不拷贝地包装接收缓冲区中的一帧
+class IoBuf {
+ public:
+  static const size_t kBlockSize = 8192;
+
+  IoBuf() = default;
+
+  // Shares the blocks; borrowed bytes are copied into blocks of our own.
+  IoBuf(const IoBuf& other);
+  IoBuf& operator=(const IoBuf& other);
+
+  IoBuf(IoBuf&& other) noexcept;
+  IoBuf& operator=(IoBuf&& other) noexcept;
+
+  ~IoBuf();
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  int segment_count() const {
+    return static_cast<int>(segments_.size() - head_);
+  }
+
+  std::string_view segment(int index) const {
+    const Segment& segment = segments_[head_ + index];
+    return std::string_view(segment.data, segment.length);
+  }
+
+  // Copies `data` into the free space of the last block and new blocks.
+  void Append(const char* data, size_t size);
+
+  void Append(std::string_view data) { Append(data.data(), data.size()); }
+
+  // Shares the blocks of `other`, no bytes are copied except borrowed ones.
+  void Append(const IoBuf& other);
+
+  void Append(IoBuf&& other);
+
+  // References memory the caller keeps alive and unchanged for as long as
+  // this IoBuf holds it. Copies of the IoBuf get their own bytes.
+  void AppendBorrowed(const char* data, size_t size);
+
+  // Moves the first `size` bytes to the end of `out`. Only a segment that
+  // straddles the cut is split, the bytes themselves don't move.
+  void Cut(size_t size, IoBuf* out);
+
+  void PopFront(size_t size);
+
+  // Writable space for `*size` bytes at the end, at most the rest of the
+  // last block or a new one. Counts as appended until TrimBack().
+  char* AppendInPlace(size_t* size);
+
+  // Drops the last `size` bytes, which must come from AppendInPlace().
+  void TrimBack(size_t size);
+
+  void Clear();
+
+  // Copies the bytes [offset, offset + length) to `dest`.
+  void CopyTo(size_t offset, size_t length, char* dest) const;
+
+  std::string ToString() const;
+
+  // Fills at most `max_count` iovecs from the front, returns how many.
+  int ToIovecs(struct iovec* iov, int max_count) const;
+
+  // Reads at most `max_size` bytes with one readv() into the last block and
+  // new blocks. Returns what readv() returned.
+  ssize_t ReadFd(int fd, size_t max_size);
+
+  // Sends from the front with one sendmsg() and drops what was sent, or
+  // moves it to `sent` if given, e.g. to keep MSG_ZEROCOPY pages alive.
+  // `flags` are added to MSG_NOSIGNAL. Returns what sendmsg() returned.
+  ssize_t WriteFd(int fd, int flags = 0, IoBuf* sent = nullptr);
+
+ private:
+  struct Block {
+    std::atomic<int> refs;
+    size_t capacity;
+    // Bytes handed out at the front; only a sole owner appends behind them.
+    size_t used;
+    char data[];
+  };
+
+  struct Segment {
+    Block* block;  // nullptr for borrowed memory.
+    const char* data;
+    size_t length;
+  };
+
+  static Block* NewBlock();
+  static void Ref(Block* block);
+  static void Unref(Block* block);
+
+  // The last block, if we may write behind its used bytes.
+  Block* WritableTail() const;
+
+  void PushSegment(const Segment& segment);
+
+  // Segments before head_ are already consumed; the vector keeps its
+  // capacity so a reused IoBuf doesn't allocate.
+  std::vector<Segment> segments_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+#endif  //PHOTONRPC_IO_BUF_H
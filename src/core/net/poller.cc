@@ -22,7 +22,9 @@ int Poller::poll(int timeout) {
 
 void Poller::RegisterChannel(Channel* channel) {
   int fd = channel->event()->data.fd;
-  this->fd_channel_map_.emplace(fd, channel);
+  // The fd is new to epoll, so any entry left for it belongs to a closed
+  // fd of the same number and must not shadow this channel.
+  this->fd_channel_map_[fd] = channel;
 
   epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, channel->event()->data.fd,
             channel->event());
@@ -36,6 +38,11 @@ void Poller::RemoveChannel(Channel* channel) {
             channel->event());
 }
 
+void Poller::UpdateChannel(Channel* channel) {
+  epoll_ctl(this->epoll_fd_, EPOLL_CTL_MOD, channel->event()->data.fd,
+            channel->event());
+}
+
 epoll_event* Poller::get_return_events() {
   return this->return_events_;
 }
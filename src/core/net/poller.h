@@ -19,6 +19,9 @@ class Poller {
 
   void RemoveChannel(Channel* channel);
 
+  // Re-applies the channel's interest set with EPOLL_CTL_MOD.
+  void UpdateChannel(Channel* channel);
+
   epoll_event* get_return_events();
 
   Channel* get_channel_by_fd(int fd);
@@ -0,0 +1,142 @@
+#include "tcp_client.h"
+#include "event_loop_thread.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <future>
+
+EventLoop* TcpClient::DefaultLoop() {
+  static EventLoopThread loop_thread;
+  static EventLoop* loop = loop_thread.StartLoop();
+  return loop;
+}
+
+TcpClient::TcpClient(
+    EventLoop* loop,
+    std::function<void(const FrameHeader&, const IoBuf&)> message_callback,
+    std::function<void(bool)> connect_callback,
+    std::function<void()> close_callback)
+    : loop_(loop),
+      connected_(false),
+      connecting_fd_(-1),
+      message_callback_(message_callback),
+      connect_callback_(connect_callback),
+      close_callback_(close_callback) {}
+
+TcpClient::~TcpClient() {
+  auto drop = [this] {
+    if (connecting_fd_ >= 0) {
+      loop_->RemoveChannel(connecting_channel_.get());
+      close(connecting_fd_);
+      connecting_fd_ = -1;
+    }
+    connecting_channel_.reset();
+    connection_.reset();
+  };
+  if (loop_->IsInLoopThread()) {
+    drop();
+    return;
+  }
+  std::promise<void> dropped;
+  loop_->QueueInLoop([&drop, &dropped] {
+    drop();
+    dropped.set_value();
+  });
+  dropped.get_future().wait();
+}
+
+void TcpClient::Connect(const std::string& ip, int port) {
+  loop_->RunInLoop([this, ip, port] { StartConnect(ip, port); });
+}
+
+void TcpClient::StartConnect(const std::string& ip, int port) {
+  if (connected_ || connecting_fd_ >= 0) {
+    return;
+  }
+
+  struct sockaddr_in server_address;
+  bzero(&server_address, sizeof(server_address));
+  server_address.sin_family = AF_INET;
+  inet_pton(AF_INET, ip.c_str(), &server_address.sin_addr);
+  server_address.sin_port = htons(port);
+
+  int sockfd = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (sockfd < 0) {
+    connect_callback_(false);
+    return;
+  }
+  if (connect(sockfd, (struct sockaddr*)&server_address,
+              sizeof(server_address)) == 0) {
+    Established(sockfd);
+    return;
+  }
+  if (errno != EINPROGRESS) {
+    close(sockfd);
+    connect_callback_(false);
+    return;
+  }
+
+  // The handshake finishes in the background; the socket turns writable.
+  connecting_fd_ = sockfd;
+  connecting_channel_ = std::make_unique<Channel>(sockfd, false, true);
+  // Errors and hang-ups are reported through the read handler.
+  connecting_channel_->set_handle_read([this] { this->HandleConnect(); });
+  connecting_channel_->set_handle_write([this] { this->HandleConnect(); });
+  loop_->AddChannel(connecting_channel_.get());
+}
+
+void TcpClient::HandleConnect() {
+  // Both handlers may fire for the same event.
+  if (connecting_fd_ < 0) {
+    return;
+  }
+  int sockfd = connecting_fd_;
+  connecting_fd_ = -1;
+  loop_->RemoveChannel(connecting_channel_.get());
+  // The channel is still on the call stack, destroy it afterwards.
+  loop_->QueueInLoop(
+      [channel = std::shared_ptr<Channel>(std::move(connecting_channel_))] {});
+
+  int error = 0;
+  socklen_t len = sizeof(error);
+  if (getsockopt(sockfd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 ||
+      error != 0) {
+    close(sockfd);
+    connect_callback_(false);
+    return;
+  }
+  Established(sockfd);
+}
+
+void TcpClient::Established(int sockfd) {
+  connection_ = std::make_shared<TcpConnection>(
+      loop_, sockfd,
+      [this](const std::shared_ptr<TcpConnection>& connection,
+             const FrameHeader& header,
+             const IoBuf& message) { message_callback_(header, message); });
+  connection_->set_close_callback(
+      [this](Channel* channel) { this->HandleClose(); });
+  // The connection exists before any Send() that sees connected().
+  connected_ = true;
+  connect_callback_(true);
+}
+
+void TcpClient::Send(std::string message, const FrameHeader& header) {
+  loop_->RunInLoop([this, message = std::move(message), header]() mutable {
+    if (connection_ != nullptr) {
+      connection_->Send(message, header);
+    }
+  });
+}
+
+void TcpClient::HandleClose() {
+  connected_ = false;
+  close_callback_();
+  // The connection is still on the call stack, destroy it afterwards.
+  loop_->QueueInLoop([closed = std::move(connection_)] {});
+}
@@ -0,0 +1,69 @@
+#ifndef PHOTONRPC_TCP_CLIENT_H
+#define PHOTONRPC_TCP_CLIENT_H
+
+#include "event_loop.h"
+#include "tcp_connection.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+// 客户端长连接
+// 连接在客户端EventLoop线程中以非阻塞方式建立，之后的读写也都在该线程中进行
+class TcpClient {
+ public:
+  // The loop shared by all clients of the process, started on first use.
+  static EventLoop* DefaultLoop();
+
+  // message_callback receives every decoded frame, as a view valid during
+  // the call, connect_callback the outcome of each connect attempt, and
+  // close_callback runs once per lost connection, all in the loop thread.
+  TcpClient(EventLoop* loop,
+            std::function<void(const FrameHeader&, const IoBuf&)>
+                message_callback,
+            std::function<void(bool)> connect_callback,
+            std::function<void()> close_callback);
+
+  // Blocks until the loop thread has dropped the connection.
+  ~TcpClient();
+
+  // Thread-safe and non-blocking. Starts connecting in the loop thread
+  // unless connected or connecting already.
+  void Connect(const std::string& ip, int port);
+
+  // Set in the loop thread before connect_callback(true) runs.
+  bool connected() const { return connected_; }
+
+  // Thread-safe, the message is written by the loop thread.
+  void Send(std::string message, const FrameHeader& header = FrameHeader());
+
+  EventLoop* loop() const { return loop_; }
+
+ private:
+  // Loop thread.
+  void StartConnect(const std::string& ip, int port);
+
+  // Loop thread. The connecting socket became writable or failed.
+  void HandleConnect();
+
+  // Loop thread. Wraps the connected socket in a TcpConnection.
+  void Established(int sockfd);
+
+  void HandleClose();
+
+  EventLoop* loop_;
+
+  std::atomic<bool> connected_;
+
+  // Owned by the loop thread: the socket of the connect in progress, or -1,
+  // and the channel waiting for it to become writable.
+  int connecting_fd_;
+  std::unique_ptr<Channel> connecting_channel_;
+  std::shared_ptr<TcpConnection> connection_;
+
+  std::function<void(const FrameHeader&, const IoBuf&)> message_callback_;
+  std::function<void(bool)> connect_callback_;
+  std::function<void()> close_callback_;
+};
+
+#endif  //PHOTONRPC_TCP_CLIENT_H
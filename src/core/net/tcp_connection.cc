@@ -1,18 +1,80 @@
 #include "tcp_connection.h"
+#include "../common/config.h"
 #include "../common/logger.h"
 #include "codec.h"
 
+#include <errno.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
-TcpConnection::TcpConnection(
-    int connect_fd, std::function<void(std::string&, std::string&)> service,
-    std::function<void(Channel*)> add_connection_callback)
-    : service_(service) {
+#include <algorithm>
+
+namespace {
+Buffer::Backend ConfiguredBackend() {
+  static const Buffer::Backend backend =
+      Buffer::ParseBackend(Config::GetInstance().buffer_backend());
+  return backend;
+}
+
+void ShrinkBuffer(Buffer* buffer, bool idle, int initial_size,
+                  int high_water) {
+  if (idle) {
+    buffer->Shrink(initial_size);
+  } else if (buffer->GetCapacity() > high_water &&
+             buffer->peak_size() <= buffer->GetCapacity() / 4) {
+    buffer->Shrink(std::max(initial_size, 2 * buffer->peak_size()));
+  }
+  buffer->ResetPeak();
+}
+
+bool IsRetryable(int saved_errno) {
+  return saved_errno == EAGAIN || saved_errno == EWOULDBLOCK ||
+         saved_errno == EINTR;
+}
+}  // namespace
+
+TcpConnection::TcpConnection(EventLoop* loop, int connect_fd,
+                             MessageCallback message_callback)
+    : loop_(loop),
+      input_buffer_(max_buffer_size, ConfiguredBackend()),
+      output_buffer_(max_buffer_size, ConfiguredBackend()),
+      decoder_(FrameVersion(), MaxFrameSize()),
+      large_frame_remaining_(0),
+      zerocopy_enabled_(false),
+      zerocopy_next_seq_(0),
+      accounted_bytes_(0),
+      active_(false),
+      idle_checks_(0),
+      closed_(false),
+      dispatching_(false),
+      message_callback_(message_callback) {
   channel_ = Channel(connect_fd, true, false);
   channel_.set_handle_read([this] { this->HandleRead(); });
   channel_.set_handle_write([this] { this->HandleWrite(); });
-  this->add_connection_callback_ = add_connection_callback;
-  add_connection_callback_(&channel_);
+  if (ZerocopyThreshold() > 0) {
+    int on = 1;
+    zerocopy_enabled_ = setsockopt(connect_fd, SOL_SOCKET, SO_ZEROCOPY, &on,
+                                   sizeof(on)) == 0;
+    channel_.set_handle_error([this] { return this->HandleError(); });
+  }
+  loop_->AddChannel(&channel_);
+  AccountBufferBytes();
+}
+
+TcpConnection::~TcpConnection() {
+  if (!closed_) {
+    // Without this the poller would keep the freed channel until the fd
+    // number is reused.
+    loop_->RemoveChannel(&channel_);
+    // Dropped without a close, e.g. on shutdown: the loop's counter gets
+    // the buffers back as well.
+    closed_ = true;
+    AccountBufferBytes();
+  }
+  close(channel_.event()->data.fd);
 }
 
 void TcpConnection::set_close_callback(
@@ -20,32 +82,320 @@ void TcpConnection::set_close_callback(
   close_callback_ = close_callback;
 }
 
+size_t TcpConnection::ChainThreshold() {
+  static const size_t threshold = static_cast<size_t>(
+      std::max(Config::GetInstance().buffer_chain_threshold(), 0));
+  return threshold;
+}
+
+size_t TcpConnection::ZerocopyThreshold() {
+  static const size_t threshold = static_cast<size_t>(
+      std::max(Config::GetInstance().buffer_zerocopy_threshold(), 0));
+  return threshold;
+}
+
+size_t TcpConnection::MaxFrameSize() {
+  static const size_t max_size = static_cast<size_t>(
+      std::max(Config::GetInstance().server_max_frame_size(), 0));
+  return max_size;
+}
+
+int TcpConnection::FrameVersion() {
+  static const int version =
+      Config::GetInstance().server_frame_version() == Codec::kVersion2
+          ? Codec::kVersion2
+          : 1;
+  return version;
+}
+
+void TcpConnection::Send(std::string& message, const FrameHeader& header) {
+  SendFrame(
+      static_cast<int>(message.size()),
+      [&message](Buffer* output) {
+        output->WriteData(message.data(), static_cast<int>(message.size()));
+      },
+      header);
+}
+
+void TcpConnection::SendFrame(
+    int size, const std::function<void(Buffer* output)>& write,
+    const FrameHeader& header) {
+  if (closed_) {
+    return;
+  }
+  char encoded[Codec::kMaxHeaderSize];
+  int header_size =
+      Codec::EncodeFrameHeader(FrameVersion(), header, size, encoded);
+  // Grown once up front, so the writer never triggers a copy.
+  output_buffer_.EnsureWritable(header_size + size);
+  output_buffer_.WriteData(encoded, header_size);
+  write(&output_buffer_);
+  if (!output_chain_.empty()) {
+    // The chain goes first, so the frame moves behind it.
+    BufferSpans frame = output_buffer_.PeekSpans();
+    output_chain_.Append(frame.first);
+    output_chain_.Append(frame.second);
+    output_buffer_.RetrieveData(frame.size());
+  }
+  if (!dispatching_) {
+    SendOutput();
+  }
+}
+
+void TcpConnection::Send(IoBuf&& message, const FrameHeader& header) {
+  if (closed_) {
+    return;
+  }
+  // What is already queued goes first.
+  if (output_buffer_.GetSize() > 0) {
+    BufferSpans queued = output_buffer_.PeekSpans();
+    output_chain_.Append(queued.first);
+    output_chain_.Append(queued.second);
+    output_buffer_.RetrieveData(output_buffer_.GetSize());
+  }
+  char encoded[Codec::kMaxHeaderSize];
+  int header_size = Codec::EncodeFrameHeader(
+      FrameVersion(), header, static_cast<int>(message.size()), encoded);
+  output_chain_.Append(encoded, header_size);
+  output_chain_.Append(std::move(message));
+  if (!dispatching_) {
+    SendOutput();
+  }
+}
+
 void TcpConnection::HandleRead() {
-  if (input_buffer_.ReceiveFd(channel_.event()->data.fd)) {
-    std::string decoded_data;
-    while ((decoded_data = Codec::decode(input_buffer_.PeekData(),
-                                         input_buffer_.GetSize()))
-               .size() > 0) {
-      // TODO: Remove the magic number of 4 here.
-      input_buffer_.RetrieveData(decoded_data.size() + 4);
-
-      std::string response_data;
-      service_(decoded_data, response_data);
-
-      std::string encoded_data = Codec::encode(response_data);
-      output_buffer_.WriteData(encoded_data, encoded_data.size());
-      // TODO: Improve the performance here.
-      while (!output_buffer_.SendFd(channel_.event()->data.fd)) {}
-      decoded_data.clear();
+  if (closed_) {
+    return;
+  }
+  active_ = true;
+  if (large_frame_remaining_ > 0) {
+    ReadLargeFrame();
+    return;
+  }
+  int saved_errno = 0;
+  if (input_buffer_.ReceiveFd(channel_.event()->data.fd, &saved_errno)) {
+    // Handlers may drop the last other reference, e.g. by closing.
+    std::shared_ptr<TcpConnection> self = shared_from_this();
+    BufferSpans data = input_buffer_.PeekSpans();
+    frames_.clear();
+    if (!decoder_.Decode(data, &frames_)) {
+      // LOG_ERROR("TcpConnection(fd:{}) bad or oversized frame length",
+      //           static_cast<int>(channel_.event()->data.fd));
+      HandleClose();
+      return;
     }
-  } else {
+    dispatching_ = true;
+    // Handlers only touch the output, so `data` stays valid throughout.
+    for (const FrameView& view : frames_) {
+      BufferSpans message = data.Sub(view.offset, view.size);
+      frame_.Clear();
+      frame_.AppendBorrowed(message.first.data(), message.first.size());
+      frame_.AppendBorrowed(message.second.data(), message.second.size());
+      message_callback_(self, view.header, frame_);
+    }
+    frame_.Clear();
+    input_buffer_.RetrieveData(static_cast<int>(decoder_.TakeDecoded()));
+    StartLargeFrame();
+    dispatching_ = false;
+    SendOutput();
+  } else if (!IsRetryable(saved_errno)) {
     // LOG_INFO("TcpConnection(fd:{}) closed",
     //          static_cast<int>(channel_.event()->data.fd));
-    close(channel_.event()->data.fd);
+    HandleClose();
   }
 }
 
-// TODO:: Take good use of reactor write to handle the case when the socket couldn't write right now.
+void TcpConnection::StartLargeFrame() {
+  if (decoder_.state() != FrameDecoder::State::kBody) {
+    return;
+  }
+  size_t threshold = ChainThreshold();
+  if (threshold == 0) {
+    return;
+  }
+  BufferSpans data = input_buffer_.PeekSpans();
+  size_t header_size = decoder_.header_size();
+  if (data.size() < header_size) {
+    // Header extensions still on the way.
+    return;
+  }
+  if (decoder_.body_size() < threshold) {
+    // The rest lands in the ring directly instead of the stack area.
+    input_buffer_.EnsureWritable(static_cast<int>(decoder_.Missing(data)));
+    return;
+  }
+  // Only the bytes of the last read are copied, the rest of the frame goes
+  // straight into the chain.
+  BufferSpans received = data.Sub(header_size, data.size() - header_size);
+  large_frame_.Append(received.first);
+  large_frame_.Append(received.second);
+  large_frame_header_ = decoder_.header();
+  large_frame_remaining_ = decoder_.body_size() - received.size();
+  input_buffer_.RetrieveData(static_cast<int>(data.size()));
+  decoder_.Reset();
+}
+
+void TcpConnection::ReadLargeFrame() {
+  ssize_t read_size =
+      large_frame_.ReadFd(channel_.event()->data.fd, large_frame_remaining_);
+  if (read_size <= 0) {
+    if (read_size == 0 || !IsRetryable(errno)) {
+      HandleClose();
+    }
+    return;
+  }
+  large_frame_remaining_ -= read_size;
+  if (large_frame_remaining_ > 0) {
+    return;
+  }
+
+  std::shared_ptr<TcpConnection> self = shared_from_this();
+  dispatching_ = true;
+  message_callback_(self, large_frame_header_, large_frame_);
+  large_frame_.Clear();
+  dispatching_ = false;
+  // Level-triggered epoll reports the bytes behind the frame again.
+  SendOutput();
+}
+
 void TcpConnection::HandleWrite() {
-  // send(channel_.event()->data.fd, output_buffer_.PeekData(), max_buffer_size, 0);
-}
\ No newline at end of file
+  if (closed_) {
+    return;
+  }
+  if (!WriteOutput()) {
+    return;
+  }
+  if (PendingOutput() == 0) {
+    channel_.DisableWriting();
+    loop_->UpdateChannel(&channel_);
+  }
+}
+
+void TcpConnection::SendOutput() {
+  // Every path that can grow a buffer ends up here.
+  AccountBufferBytes();
+  // While EPOLLOUT is armed HandleWrite() owns the flushing, which keeps the
+  // bytes in order.
+  if (closed_ || channel_.IsWriting() || PendingOutput() == 0) {
+    return;
+  }
+  if (!WriteOutput()) {
+    return;
+  }
+  // A slow reader only costs buffer memory: park the rest until writable.
+  if (PendingOutput() > 0) {
+    channel_.EnableWriting();
+    loop_->UpdateChannel(&channel_);
+  }
+}
+
+bool TcpConnection::WriteOutput() {
+  // Also a reply written straight from Send(), which HandleWrite() never
+  // sees.
+  active_ = true;
+  int fd = channel_.event()->data.fd;
+  int saved_errno = 0;
+  bool written;
+  if (!output_chain_.empty()) {
+    ssize_t send_size = 0;
+    bool zerocopy =
+        zerocopy_enabled_ && output_chain_.size() >= ZerocopyThreshold();
+    if (zerocopy) {
+      IoBuf sent;
+      send_size = output_chain_.WriteFd(fd, MSG_ZEROCOPY, &sent);
+      if (send_size > 0) {
+        // The kernel numbers every successful zero-copy send.
+        zerocopy_pending_.emplace_back(zerocopy_next_seq_++, std::move(sent));
+      }
+      // Out of memory for pinning the pages: copy this time.
+      zerocopy = send_size >= 0 || errno != ENOBUFS;
+    }
+    if (!zerocopy) {
+      send_size = output_chain_.WriteFd(fd);
+    }
+    written = send_size > 0;
+    saved_errno = send_size == 0 ? 0 : errno;
+  } else {
+    written = output_buffer_.SendFd(fd, &saved_errno);
+  }
+  if (!written && !IsRetryable(saved_errno)) {
+    HandleClose();
+    return false;
+  }
+  return true;
+}
+
+bool TcpConnection::HandleError() {
+  if (closed_) {
+    return false;
+  }
+  bool drained = false;
+  char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+  while (true) {
+    struct msghdr message = {};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (recvmsg(channel_.event()->data.fd, &message, MSG_ERRQUEUE) < 0) {
+      break;
+    }
+    drained = true;
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+            (cmsg->cmsg_level == SOL_IPV6 &&
+             cmsg->cmsg_type == IPV6_RECVERR))) {
+        continue;
+      }
+      struct sock_extended_err error;
+      memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+      if (error.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+        continue;
+      }
+      // [ee_info, ee_data] completed; completions arrive in order, so
+      // everything up to ee_data can go.
+      while (!zerocopy_pending_.empty() &&
+             static_cast<int32_t>(zerocopy_pending_.front().first -
+                                  error.ee_data) <= 0) {
+        zerocopy_pending_.pop_front();
+      }
+      // E.g. loopback: the kernel copied, so pinning only costs.
+      if (error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        zerocopy_enabled_ = false;
+      }
+    }
+  }
+  return drained;
+}
+
+void TcpConnection::ReclaimBuffers(int idle_checks, int high_water) {
+  if (closed_) {
+    return;
+  }
+  idle_checks_ = active_ ? 0 : idle_checks_ + 1;
+  active_ = false;
+  bool idle = idle_checks > 0 && idle_checks_ >= idle_checks;
+  ShrinkBuffer(&input_buffer_, idle, max_buffer_size, high_water);
+  ShrinkBuffer(&output_buffer_, idle, max_buffer_size, high_water);
+  AccountBufferBytes();
+}
+
+void TcpConnection::AccountBufferBytes() {
+  int64_t bytes = closed_ ? 0
+                          : static_cast<int64_t>(input_buffer_.GetCapacity()) +
+                                output_buffer_.GetCapacity();
+  if (bytes != accounted_bytes_) {
+    loop_->AddBufferBytes(bytes - accounted_bytes_);
+    accounted_bytes_ = bytes;
+  }
+}
+
+void TcpConnection::HandleClose() {
+  closed_ = true;
+  // The storage goes back to the pool with the connection.
+  AccountBufferBytes();
+  // The fd is closed by the destructor, once the owner has dropped us.
+  loop_->RemoveChannel(&channel_);
+  if (close_callback_) {
+    close_callback_(&channel_);
+  }
+}
@@ -2,37 +2,158 @@
 #define PHOTONRPC_TCP_CONNECTION_H
 
 #include "buffer.h"
+#include "frame_decoder.h"
+#include "io_buf.h"
 #include "net/channel.h"
+#include "net/event_loop.h"
 
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
-class TcpConnection {
+// 由shared_ptr持有，回复可以在请求处理完之后再通过Send()发出
+class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
  public:
-  TcpConnection(int connect_fd,
-                std::function<void(std::string&, std::string&)> service,
-                std::function<void(Channel*)> add_connection_callback);
+  // Receives every decoded frame in the loop thread, without the frame
+  // header, whose fields come in `header`. The message is only valid during
+  // the call: small frames borrow the input buffer, large ones are read
+  // into a block chain of their own.
+  using MessageCallback =
+      std::function<void(const std::shared_ptr<TcpConnection>& connection,
+                         const FrameHeader& header, const IoBuf& message)>;
+
+  // Must be constructed and destroyed in the thread of `loop`, which owns
+  // the connection's channel.
+  TcpConnection(EventLoop* loop, int connect_fd,
+                MessageCallback message_callback);
 
   TcpConnection() = delete;
 
+  ~TcpConnection();
+
   void set_close_callback(std::function<void(Channel*)> close_callback);
 
+  // Frames and queues `message`. Loop thread only. Replies sent while the
+  // frames of one read are being dispatched go out in a single write.
+  // `header` only reaches the wire in frame version 2.
+  void Send(std::string& message, const FrameHeader& header = FrameHeader());
+
+  // Same, but queues the blocks of `message` without copying them.
+  void Send(IoBuf&& message, const FrameHeader& header = FrameHeader());
+
+  // Same, for a `size`-byte message that `write` appends to `output`
+  // itself, e.g. by serializing into it in place. Exactly `size` bytes.
+  void SendFrame(int size, const std::function<void(Buffer* output)>& write,
+                 const FrameHeader& header = FrameHeader());
+
+  EventLoop* loop() const { return loop_; }
+
+  // Bytes queued behind what the socket took. Loop thread only.
+  size_t PendingOutput() const {
+    return output_chain_.size() + output_buffer_.GetSize();
+  }
+
+  // Whether EPOLLOUT is armed to flush the pending output. Loop thread only.
+  bool IsWriting() const { return channel_.IsWriting(); }
+
+  // Loop thread, called periodically. Buffers that grew past `high_water`
+  // bytes but used at most a quarter of that since the last call shrink
+  // to twice their peak. After `idle_checks` calls without any I/O both
+  // buffers go back to their initial size.
+  void ReclaimBuffers(int idle_checks, int high_water);
+
+  // Frames of at least this size travel as block chains, 0 if disabled.
+  static size_t ChainThreshold();
+
+  // Output chains of at least this size are sent with MSG_ZEROCOPY, 0 if
+  // disabled.
+  static size_t ZerocopyThreshold();
+
+  // Codec frame version spoken by every connection, 1 or 2.
+  static int FrameVersion();
+
+  // Largest frame body a connection accepts, 0 if unlimited. A peer that
+  // announces a larger one is disconnected.
+  static size_t MaxFrameSize();
+
  private:
+  EventLoop* loop_;
   Channel channel_;
 
+  // Initial size of both buffers.
   const int max_buffer_size = 1024;
   Buffer input_buffer_;
   Buffer output_buffer_;
 
+  // Keeps the header state of a partial frame across reads.
+  FrameDecoder decoder_;
+  // Frames of the last read, reused between reads.
+  std::vector<FrameView> frames_;
+  // Reused to wrap each frame of the input buffer.
+  IoBuf frame_;
+
+  // A frame of at least the chain threshold is read straight into
+  // large_frame_ instead of growing the input buffer to its size.
+  IoBuf large_frame_;
+  FrameHeader large_frame_header_;
+  size_t large_frame_remaining_;
+
+  // Output queued by Send(IoBuf&&). While it holds data every later send
+  // is appended here too, so output_buffer_ is then empty and the bytes
+  // stay in order.
+  IoBuf output_chain_;
+
+  // Set if SO_ZEROCOPY was accepted and the kernel hasn't fallen back to
+  // copying anyway.
+  bool zerocopy_enabled_;
+  // Bytes of each MSG_ZEROCOPY send, by the sequence number the kernel
+  // gives it, kept alive until its completion arrives.
+  uint32_t zerocopy_next_seq_;
+  std::deque<std::pair<uint32_t, IoBuf>> zerocopy_pending_;
+
   // 注册给epoll的函数
   void HandleRead();
 
   //注册给epoll的函数
   void HandleWrite();
 
-  // std::function<void(char* read, char* write)> service_;
-  std::function<void(std::string& read, std::string& write)> service_;
-  std::function<void(Channel*)> add_connection_callback_;
+  // Writes what the socket takes now and arms EPOLLOUT for the rest.
+  void SendOutput();
+
+  // One write from whichever output holds data. Returns false if that
+  // closed the connection.
+  bool WriteOutput();
+
+  // Drains MSG_ZEROCOPY completions from the error queue. Returns false if
+  // there were none.
+  bool HandleError();
+
+  // Switches to large_frame_ if the partial frame in the input buffer is
+  // at least the chain threshold, otherwise makes room for the rest of it.
+  void StartLargeFrame();
+
+  void ReadLargeFrame();
+
+  void HandleClose();
+
+  // Reports capacity changes of the buffers to EventLoop::buffer_bytes().
+  void AccountBufferBytes();
+
+  // Capacity last added to the loop's counter.
+  int64_t accounted_bytes_;
+  // Set by every read and write, cleared by ReclaimBuffers().
+  bool active_;
+  int idle_checks_;
+
+  bool closed_;
+  bool dispatching_;
+
+  MessageCallback message_callback_;
   std::function<void(Channel*)> close_callback_;
 };
 
-#endif  //PHOTONRPC_TCP_CONNECTION_H
\ No newline at end of file
+#endif  //PHOTONRPC_TCP_CONNECTION_H
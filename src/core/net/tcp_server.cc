@@ -1,31 +1,181 @@
 #include "tcp_server.h"
 
+#include "../common/config.h"
 #include "../common/logger.h"
 
+#include <unistd.h>
+
+#include <future>
+
+TcpServer::TcpServer()
+    : loop_pool_(&event_loop_, Config::GetInstance().server_io_thread_num(),
+                 EventLoopThreadPool::ParseDispatchPolicy(
+                     Config::GetInstance().server_dispatch_policy())),
+      stopping_(false) {
+  // CPU steering only keeps a connection local if listener i runs on CPU i.
+  loop_pool_.set_pin_cpus(Config::GetInstance().server_reuse_port() &&
+                          Config::GetInstance().server_reuseport_cbpf());
+}
+
+TcpServer::~TcpServer() {
+  // Stop the I/O threads before their connections are destroyed.
+  loop_pool_.Stop();
+}
+
 void TcpServer::SetUpTcpServer(
-    std::function<void(std::string&, std::string&)> service) {
+    TcpConnection::MessageCallback message_callback) {
+  message_callback_ = message_callback;
+  loop_pool_.Start();
+  for (EventLoop* loop : ConnectionLoops()) {
+    loop_connections_[loop];
+  }
+  StartBufferReclaim();
+}
+
+void TcpServer::StartListen() {
+  if (Config::GetInstance().server_reuse_port() &&
+      loop_pool_.thread_num() > 0) {
+    SetUpReusePortListeners();
+    return;
+  }
+
   acceptor_.set_start_listen_callback([this](Channel* channel) {
     // LOG_DEBUG("Acceptor called listen_callback");
     event_loop_.AddChannel(channel);
   });
 
-  acceptor_.set_new_connection_callback([this, service](int connect_fd) {
-    fd_connection_map_.insert(
-        {connect_fd, std::make_unique<TcpConnection>(
-                         connect_fd, service, [this](Channel* channel) {
-                           event_loop_.AddChannel(channel);
-                         })});
-    fd_connection_map_.find(connect_fd)
-        ->second->set_close_callback([this](Channel* channel) {
-          this->event_loop_.RemoveChannel(channel);
-          this->fd_connection_map_.erase(channel->event()->data.fd);
-        });
-    // LOG_INFO("TcpServer created new TcpConnection for fd: {}", connect_fd);
+  acceptor_.set_new_connection_callback([this](int connect_fd) {
+    EventLoop* loop = loop_pool_.GetNextLoop();
+    loop->RunInLoop(
+        [this, loop, connect_fd] { this->NewConnection(loop, connect_fd); });
   });
 
   acceptor_.StartListen();
 }
 
+void TcpServer::SetUpReusePortListeners() {
+  for (int i = 0; i < loop_pool_.thread_num(); i++) {
+    EventLoop* loop = loop_pool_.GetLoop(i);
+    auto acceptor = std::make_unique<Acceptor>(true);
+
+    acceptor->set_start_listen_callback([loop](Channel* channel) {
+      loop->RunInLoop([loop, channel] { loop->AddChannel(channel); });
+    });
+
+    // Accepted in the loop's own thread, no hand-off needed.
+    acceptor->set_new_connection_callback([this, loop](int connect_fd) {
+      loop_pool_.AcquireLoop(loop);
+      this->NewConnection(loop, connect_fd);
+    });
+
+    // Listening in order makes listener i member i of the reuseport group.
+    acceptor->StartListen();
+    reuse_port_acceptors_.push_back(std::move(acceptor));
+  }
+
+  if (Config::GetInstance().server_reuseport_cbpf()) {
+    reuse_port_acceptors_.front()->AttachCpuSteering(loop_pool_.thread_num());
+  }
+}
+
+std::vector<EventLoop*> TcpServer::ConnectionLoops() {
+  std::vector<EventLoop*> loops;
+  for (int i = 0; i < loop_pool_.thread_num(); i++) {
+    loops.push_back(loop_pool_.GetLoop(i));
+  }
+  if (loops.empty()) {
+    loops.push_back(&event_loop_);
+  }
+  return loops;
+}
+
+void TcpServer::StartBufferReclaim() {
+  int interval_ms = Config::GetInstance().buffer_reclaim_interval_ms();
+  if (interval_ms <= 0) {
+    return;
+  }
+  for (EventLoop* loop : ConnectionLoops()) {
+    loop->RunInLoop([this, loop, interval_ms] {
+      loop->RunEvery(interval_ms, [this, loop] { this->ReclaimBuffers(loop); });
+    });
+  }
+}
+
+void TcpServer::ReclaimBuffers(EventLoop* loop) {
+  int interval_ms = Config::GetInstance().buffer_reclaim_interval_ms();
+  int idle_checks =
+      (Config::GetInstance().buffer_idle_timeout_ms() + interval_ms - 1) /
+      interval_ms;
+  int high_water = Config::GetInstance().buffer_high_water();
+
+  // Only this loop's own connections, ReclaimBuffers() doesn't close any.
+  for (auto& [fd, connection] : loop_connections_.at(loop)) {
+    connection->ReclaimBuffers(idle_checks, high_water);
+  }
+}
+
+int64_t TcpServer::buffer_bytes() const {
+  int64_t bytes = event_loop_.buffer_bytes();
+  for (int i = 0; i < loop_pool_.thread_num(); i++) {
+    bytes += loop_pool_.GetLoop(i)->buffer_bytes();
+  }
+  return bytes;
+}
+
 void TcpServer::RunLoop() {
+  event_loop_.HandleStopSignals();
+  StartListen();
   event_loop_.Loop();
+  if (loop_exit_callback_) {
+    loop_exit_callback_();
+  }
+  DropConnections();
+  loop_pool_.Stop();
+}
+
+void TcpServer::DropConnections() {
+  stopping_ = true;
+  for (EventLoop* loop : ConnectionLoops()) {
+    if (loop == &event_loop_) {
+      // The main loop has quit, so its connections can go from here.
+      DropConnections(loop);
+      continue;
+    }
+    std::promise<void> dropped;
+    loop->RunInLoop([this, loop, &dropped] {
+      this->DropConnections(loop);
+      dropped.set_value();
+    });
+    dropped.get_future().wait();
+  }
+}
+
+void TcpServer::DropConnections(EventLoop* loop) {
+  // Destroyed here unless a reply still holds one.
+  loop_connections_.at(loop).clear();
+}
+
+void TcpServer::NewConnection(EventLoop* loop, int connect_fd) {
+  if (stopping_) {
+    close(connect_fd);
+    loop_pool_.ReleaseLoop(loop);
+    return;
+  }
+  auto connection =
+      std::make_shared<TcpConnection>(loop, connect_fd, message_callback_);
+  connection->set_close_callback([this, loop](Channel* channel) {
+    int fd = channel->event()->data.fd;
+    // The connection is still on the call stack, destroy it afterwards.
+    loop->QueueInLoop([this, loop, fd] { this->RemoveConnection(loop, fd); });
+  });
+
+  loop_connections_.at(loop)[connect_fd] = std::move(connection);
+  // LOG_INFO("TcpServer created new TcpConnection for fd: {}", connect_fd);
+}
+
+void TcpServer::RemoveConnection(EventLoop* loop, int connect_fd) {
+  // The fd is closed with the last reference, so it can't be reused before
+  // the entry is gone.
+  loop_connections_.at(loop).erase(connect_fd);
+  loop_pool_.ReleaseLoop(loop);
 }
@@ -3,23 +3,85 @@
 
 #include "acceptor.h"
 #include "event_loop.h"
+#include "event_loop_thread_pool.h"
 #include "tcp_connection.h"
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <vector>
 
 class TcpServer {
  public:
-  TcpServer() = default;
+  TcpServer();
 
-  void SetUpTcpServer(std::function<void(std::string&, std::string&)> service);
+  ~TcpServer();
 
+  // Starts the I/O loops. Nothing is accepted before RunLoop().
+  void SetUpTcpServer(TcpConnection::MessageCallback message_callback);
+
+  // Runs in the main thread once the main loop has quit, while the I/O
+  // loops can still take tasks.
+  void set_loop_exit_callback(std::function<void()> loop_exit_callback) {
+    loop_exit_callback_ = loop_exit_callback;
+  }
+
+  // Starts listening and runs the main loop until Quit() or a stop signal.
   void RunLoop();
 
+  // Makes RunLoop() return. Any thread.
+  void Quit() { event_loop_.Quit(); }
+
+  // Storage held by the buffers of all connections. Any thread, until
+  // RunLoop() returns.
+  int64_t buffer_bytes() const;
+
  private:
+  // Runs in the thread of the loop chosen for the connection.
+  void NewConnection(EventLoop* loop, int connect_fd);
+
+  void RemoveConnection(EventLoop* loop, int connect_fd);
+
+  // Destroys every connection in the thread of its loop, while the loops
+  // still exist. Main thread, once the main loop has quit.
+  void DropConnections();
+
+  // Runs in the thread of `loop`.
+  void DropConnections(EventLoop* loop);
+
+  void StartListen();
+
+  // Shared-nothing mode: every I/O loop accepts on its own listener.
+  void SetUpReusePortListeners();
+
+  // The loops that own connections: the I/O loops, or the main loop if
+  // there are none.
+  std::vector<EventLoop*> ConnectionLoops();
+
+  // Starts the periodic buffer reclamation on every loop that owns
+  // connections, if configured.
+  void StartBufferReclaim();
+
+  // Runs in the thread of `loop`.
+  void ReclaimBuffers(EventLoop* loop);
+
+  // Main reactor: only the listening socket lives here unless the pool
+  // is configured with zero I/O threads.
   EventLoop event_loop_;
+  EventLoopThreadPool loop_pool_;
 
   Acceptor acceptor_;
-  std::map<int, std::unique_ptr<TcpConnection>> fd_connection_map_;
+  std::vector<std::unique_ptr<Acceptor>> reuse_port_acceptors_;
+  TcpConnection::MessageCallback message_callback_;
+  std::function<void()> loop_exit_callback_;
+
+  // The connections of each loop that owns any, by fd. The outer map is
+  // filled once by SetUpTcpServer(); each inner one is only touched by the
+  // thread of its loop, so none of them needs a lock.
+  std::map<EventLoop*, std::map<int, std::shared_ptr<TcpConnection>>>
+      loop_connections_;
+  // Set by DropConnections(); connections accepted later are closed at once.
+  std::atomic<bool> stopping_;
 };
 
-#endif  //PHOTONRPC_TCP_SERVER_H
\ No newline at end of file
+#endif  //PHOTONRPC_TCP_SERVER_H
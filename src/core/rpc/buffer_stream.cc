@@ -0,0 +1,12 @@
+#include "buffer_stream.h"
+
+bool BufferOutputStream::Next(void** data, int* size) {
+  *data = buffer_->AppendAvailable(size);
+  byte_count_ += *size;
+  return true;
+}
+
+void BufferOutputStream::BackUp(int count) {
+  buffer_->Unwrite(count);
+  byte_count_ -= count;
+}
@@ -0,0 +1,25 @@
+#ifndef PHOTONRPC_BUFFER_STREAM_H
+#define PHOTONRPC_BUFFER_STREAM_H
+
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include "../net/buffer.h"
+
+// 让protobuf直接序列化到连接的环形输出缓冲区中，数据跨越缓冲区末尾时分两段写入
+
+// Appends to a Buffer, handing out its free space piece by piece. The
+// buffer must not be used otherwise until the stream is destroyed.
+class BufferOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  explicit BufferOutputStream(Buffer* buffer) : buffer_(buffer) {}
+
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  int64_t ByteCount() const override { return byte_count_; }
+
+ private:
+  Buffer* buffer_;
+  int64_t byte_count_ = 0;
+};
+
+#endif  //PHOTONRPC_BUFFER_STREAM_H
@@ -0,0 +1,55 @@
+#include "io_buf_stream.h"
+
+bool IoBufInputStream::Next(const void** data, int* size) {
+  while (segment_ < buf_.segment_count()) {
+    std::string_view segment = buf_.segment(segment_);
+    if (offset_ < segment.size()) {
+      *data = segment.data() + offset_;
+      *size = static_cast<int>(segment.size() - offset_);
+      offset_ = segment.size();
+      byte_count_ += *size;
+      return true;
+    }
+    segment_++;
+    offset_ = 0;
+  }
+  return false;
+}
+
+void IoBufInputStream::BackUp(int count) {
+  // Only the tail of the last Next() may be backed up.
+  offset_ -= count;
+  byte_count_ -= count;
+}
+
+bool IoBufInputStream::Skip(int count) {
+  while (count > 0) {
+    if (segment_ >= buf_.segment_count()) {
+      return false;
+    }
+    size_t available = buf_.segment(segment_).size() - offset_;
+    if (static_cast<size_t>(count) < available) {
+      offset_ += count;
+      byte_count_ += count;
+      return true;
+    }
+    count -= static_cast<int>(available);
+    byte_count_ += available;
+    segment_++;
+    offset_ = 0;
+  }
+  return true;
+}
+
+bool IoBufOutputStream::Next(void** data, int* size) {
+  size_t available;
+  *data = buf_->AppendInPlace(&available);
+  *size = static_cast<int>(available);
+  byte_count_ += available;
+  return true;
+}
+
+void IoBufOutputStream::BackUp(int count) {
+  buf_->TrimBack(count);
+  byte_count_ -= count;
+}
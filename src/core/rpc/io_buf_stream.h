@@ -0,0 +1,42 @@
+#ifndef PHOTONRPC_IO_BUF_STREAM_H
+#define PHOTONRPC_IO_BUF_STREAM_H
+
+#include <google/protobuf/io/zero_copy_stream.h>
+
+#include "../net/io_buf.h"
+
+// 让protobuf直接在IoBuf的各个内存块上解析和序列化，不经过中间的std::string
+
+// Reads the segments of an IoBuf, which must not change while in use.
+class IoBufInputStream : public google::protobuf::io::ZeroCopyInputStream {
+ public:
+  explicit IoBufInputStream(const IoBuf& buf) : buf_(buf) {}
+
+  bool Next(const void** data, int* size) override;
+  void BackUp(int count) override;
+  bool Skip(int count) override;
+  int64_t ByteCount() const override { return byte_count_; }
+
+ private:
+  const IoBuf& buf_;
+  int segment_ = 0;
+  // Bytes of the current segment already handed out.
+  size_t offset_ = 0;
+  int64_t byte_count_ = 0;
+};
+
+// Appends to an IoBuf, handing out the free space of its blocks.
+class IoBufOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  explicit IoBufOutputStream(IoBuf* buf) : buf_(buf) {}
+
+  bool Next(void** data, int* size) override;
+  void BackUp(int count) override;
+  int64_t ByteCount() const override { return byte_count_; }
+
+ private:
+  IoBuf* buf_;
+  int64_t byte_count_ = 0;
+};
+
+#endif  //PHOTONRPC_IO_BUF_STREAM_H
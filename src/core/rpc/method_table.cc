@@ -0,0 +1,99 @@
+#include "method_table.h"
+#include "rpc_codec.h"
+
+namespace {
+// Tries this many seeds per table size before doubling it.
+const int kSeedsPerSize = 32;
+}  // namespace
+
+size_t PerfectHash::Slot(uint64_t key, uint64_t seed, uint64_t mask) {
+  // splitmix64 finalizer, so every key bit reaches the low bits.
+  uint64_t x = key ^ seed;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return static_cast<size_t>(x & mask);
+}
+
+void PerfectHash::Build(const std::vector<uint64_t>& keys) {
+  slots_.clear();
+  if (keys.empty()) {
+    return;
+  }
+  // At most half full, so a seed without collisions is quick to find.
+  size_t size = 1;
+  while (size < 2 * keys.size()) {
+    size *= 2;
+  }
+  std::vector<uint32_t> slots;
+  while (true) {
+    for (uint64_t seed = 1; seed <= kSeedsPerSize; seed++) {
+      slots.assign(size, kNotFound);
+      bool collided = false;
+      for (size_t i = 0; i < keys.size() && !collided; i++) {
+        uint32_t& slot = slots[Slot(keys[i], seed, size - 1)];
+        collided = slot != kNotFound;
+        slot = static_cast<uint32_t>(i);
+      }
+      if (!collided) {
+        slots_.swap(slots);
+        seed_ = seed;
+        mask_ = size - 1;
+        return;
+      }
+    }
+    size *= 2;
+  }
+}
+
+void MethodTable::Register(google::protobuf::Service* service) {
+  const google::protobuf::ServiceDescriptor* service_desc =
+      service->GetDescriptor();
+  for (int i = 0; i < service_desc->method_count(); i++) {
+    const google::protobuf::MethodDescriptor* method = service_desc->method(i);
+    uint64_t key = MethodKey(method->full_name());
+    uint64_t name_key = MethodKey(service_desc->name(), method->name());
+    if (FindByKey(key) != kInvalidId ||
+        FindByName(service_desc->name(), method->name()) != kInvalidId) {
+      continue;
+    }
+    entries_.push_back({service, method, &service->GetRequestPrototype(method),
+                        &service->GetResponsePrototype(method), key,
+                        name_key});
+    // Rebuilt per method, so the lookups above see the ones just added.
+    std::vector<uint64_t> keys;
+    std::vector<uint64_t> name_keys;
+    for (const Entry& entry : entries_) {
+      keys.push_back(entry.key);
+      name_keys.push_back(entry.name_key);
+    }
+    by_key_.Build(keys);
+    by_name_.Build(name_keys);
+  }
+}
+
+uint32_t MethodTable::FindByKey(uint64_t key) const {
+  uint32_t id = by_key_.Lookup(key);
+  return id != kInvalidId && entries_[id].key == key ? id : kInvalidId;
+}
+
+uint32_t MethodTable::FindByFullName(std::string_view full_name) const {
+  uint32_t id = FindByKey(MethodKey(full_name));
+  return id != kInvalidId && entries_[id].method->full_name() == full_name
+             ? id
+             : kInvalidId;
+}
+
+uint32_t MethodTable::FindByName(std::string_view service_name,
+                                 std::string_view method_name) const {
+  uint32_t id = by_name_.Lookup(MethodKey(service_name, method_name));
+  if (id == kInvalidId) {
+    return kInvalidId;
+  }
+  // The hash only narrows it down to one candidate.
+  const google::protobuf::MethodDescriptor* method = entries_[id].method;
+  return method->name() == method_name &&
+                 method->service()->name() == service_name
+             ? id
+             : kInvalidId;
+}
@@ -0,0 +1,73 @@
+#ifndef PHOTONRPC_METHOD_TABLE_H
+#define PHOTONRPC_METHOD_TABLE_H
+
+#include <google/protobuf/service.h>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// 64位键到下标的完美哈希：构建时换种子（必要时加倍槽位）直到没有冲突
+// 查找只算一次哈希、读一个槽位，调用方再比对键本身排除未知的键
+class PerfectHash {
+ public:
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+
+  // Maps keys[i] to i. The keys must be distinct.
+  void Build(const std::vector<uint64_t>& keys);
+
+  // The index `key` would have; a key that wasn't built may land anywhere.
+  uint32_t Lookup(uint64_t key) const {
+    return slots_.empty() ? kNotFound : slots_[Slot(key, seed_, mask_)];
+  }
+
+ private:
+  static size_t Slot(uint64_t key, uint64_t seed, uint64_t mask);
+
+  std::vector<uint32_t> slots_;
+  uint64_t seed_ = 0;
+  uint64_t mask_ = 0;
+};
+
+// 服务端的方法分发表，ServiceRegister()时建立一次
+// 每个方法分配一个紧凑的整数ID，ID直接索引到方法描述和请求/响应原型
+// 按名字（旧信封）或按MethodKey（紧凑信封）的请求都经完美哈希一步找到ID
+class MethodTable {
+ public:
+  static constexpr uint32_t kInvalidId = PerfectHash::kNotFound;
+
+  struct Entry {
+    google::protobuf::Service* service;
+    const google::protobuf::MethodDescriptor* method;
+    const google::protobuf::Message* request_prototype;
+    const google::protobuf::Message* response_prototype;
+    // MethodKey() of the full name and of "Service.Method" as the
+    // rpc::RpcMessage envelope names it.
+    uint64_t key;
+    uint64_t name_key;
+  };
+
+  // Appends the methods of `service`, numbered on from the last one, and
+  // rebuilds the hashes. A method whose key or name is taken is skipped.
+  void Register(google::protobuf::Service* service);
+
+  size_t size() const { return entries_.size(); }
+
+  // nullptr for an unknown ID.
+  const Entry* Get(uint32_t id) const {
+    return id < entries_.size() ? &entries_[id] : nullptr;
+  }
+
+  // kInvalidId if not registered.
+  uint32_t FindByKey(uint64_t key) const;
+  uint32_t FindByFullName(std::string_view full_name) const;
+  uint32_t FindByName(std::string_view service_name,
+                      std::string_view method_name) const;
+
+ private:
+  std::vector<Entry> entries_;
+  PerfectHash by_key_;
+  PerfectHash by_name_;
+};
+
+#endif  //PHOTONRPC_METHOD_TABLE_H
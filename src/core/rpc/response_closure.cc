@@ -0,0 +1,142 @@
+#include "response_closure.h"
+
+#include "buffer_stream.h"
+#include "io_buf_stream.h"
+#include "rpc_codec.h"
+
+#include <vector>
+
+namespace {
+// Closures are acquired and released by the same loop thread, so the pool
+// needs no locking.
+const size_t kMaxPooledClosures = 1024;
+// Clear() keeps the capacity of strings and repeated fields. Messages that
+// grew beyond this are dropped rather than pooled, and the pool as a whole
+// keeps at most kMaxPooledBytes of message memory per thread.
+const size_t kMaxPooledMessageBytes = 64 * 1024;
+const size_t kMaxPooledBytes = 16 * 1024 * 1024;
+
+thread_local std::vector<std::unique_ptr<ResponseClosure>> closure_pool;
+thread_local size_t closure_pool_bytes = 0;
+
+void ResetMessage(std::unique_ptr<google::protobuf::Message>& message,
+                  const google::protobuf::Message& prototype) {
+  if (message != nullptr &&
+      message->GetDescriptor() == prototype.GetDescriptor()) {
+    message->Clear();
+  } else {
+    message.reset(prototype.New());
+  }
+}
+}  // namespace
+
+ResponseClosure* ResponseClosure::Acquire(
+    const std::shared_ptr<TcpConnection>& connection, uint32_t id,
+    uint64_t request_id, const google::protobuf::Message& request_prototype,
+    const google::protobuf::Message& response_prototype) {
+  ResponseClosure* closure;
+  if (closure_pool.empty()) {
+    closure = new ResponseClosure();
+  } else {
+    closure = closure_pool.back().release();
+    closure_pool.pop_back();
+    closure_pool_bytes -= closure->message_bytes_;
+  }
+
+  closure->loop_ = connection->loop();
+  closure->connection_ = connection;
+  ResetMessage(closure->request_, request_prototype);
+  ResetMessage(closure->response_, response_prototype);
+  closure->response_message_.set_id(id);
+  closure->response_message_.set_type(rpc::RPC_TYPE_RESPONSE);
+  closure->compact_envelope_.type = rpc::RPC_TYPE_RESPONSE;
+  closure->compact_envelope_.id = id;
+  closure->response_header_.request_id = request_id;
+  closure->response_header_.flags = Codec::kFlagResponse;
+  return closure;
+}
+
+void ResponseClosure::Run() {
+  // Every byte is written once: straight into the output buffer by the
+  // loop, or into a block chain here for large responses. The finishing
+  // thread still does the size walk, which keeps the loop's share small.
+  response_size_ = response_->ByteSizeLong();
+  // The method is done with both messages; the pool decides on this.
+  message_bytes_ = request_->SpaceUsedLong() + response_->SpaceUsedLong();
+  if (UseCompactEnvelope()) {
+    envelope_size_ = kCompactEnvelopeSize + response_size_;
+  } else {
+    envelope_size_ = EnvelopeSize(
+        response_message_, rpc::RpcMessage::kResponseFieldNumber,
+        response_size_);
+  }
+  size_t threshold = TcpConnection::ChainThreshold();
+  if (threshold > 0 && envelope_size_ >= threshold) {
+    IoBufOutputStream output(&chain_);
+    SerializeResponse(&output);
+  }
+
+  // Inline when the method finished in the loop thread. Otherwise the
+  // closure itself is the queue node, so the hop doesn't allocate.
+  loop_->RunInLoop(static_cast<LoopTask*>(this));
+}
+
+void ResponseClosure::Finish() {
+  // The connection may have been closed in the meantime.
+  if (auto connection = connection_.lock()) {
+    if (!chain_.empty()) {
+      connection->Send(std::move(chain_), response_header_);
+    } else {
+      connection->SendFrame(
+          static_cast<int>(envelope_size_),
+          [this](Buffer* output) {
+            BufferOutputStream stream(output);
+            SerializeResponse(&stream);
+          },
+          response_header_);
+    }
+  }
+  chain_.Clear();
+  connection_.reset();
+  Recycle();
+}
+
+void ResponseClosure::Release() {
+  connection_.reset();
+  message_bytes_ = request_->SpaceUsedLong() + response_->SpaceUsedLong();
+  Recycle();
+}
+
+size_t ResponseClosure::pooled_count() {
+  return closure_pool.size();
+}
+
+size_t ResponseClosure::pooled_bytes() {
+  return closure_pool_bytes;
+}
+
+void ResponseClosure::Recycle() {
+  if (message_bytes_ > kMaxPooledMessageBytes) {
+    // Acquire() creates fresh ones.
+    request_.reset();
+    response_.reset();
+    message_bytes_ = 0;
+  }
+  if (closure_pool.size() < kMaxPooledClosures &&
+      closure_pool_bytes + message_bytes_ <= kMaxPooledBytes) {
+    closure_pool_bytes += message_bytes_;
+    closure_pool.emplace_back(this);
+  } else {
+    delete this;
+  }
+}
+
+void ResponseClosure::SerializeResponse(
+    google::protobuf::io::ZeroCopyOutputStream* output) const {
+  if (UseCompactEnvelope()) {
+    SerializeCompact(compact_envelope_, *response_, output);
+  } else {
+    SerializeEnvelope(response_message_, rpc::RpcMessage::kResponseFieldNumber,
+                      *response_, response_size_, output);
+  }
+}
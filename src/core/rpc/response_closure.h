@@ -0,0 +1,82 @@
+#ifndef PHOTONRPC_RESPONSE_CLOSURE_H
+#define PHOTONRPC_RESPONSE_CLOSURE_H
+
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/service.h>
+
+#include <memory>
+#include <string>
+#include "photonrpc/rpc_message.pb.h"
+#include "../net/tcp_connection.h"
+#include "rpc_codec.h"
+
+// 服务端调用的done，持有请求和响应对象
+// 处理函数可以在任意线程调用Run()，响应总是回到连接所在的EventLoop发送
+// 发送后对象回到该EventLoop线程的缓存池，下次调用直接复用
+// 占用内存过大的请求和响应对象不随之缓存，缓存池总量也有上限
+class ResponseClosure : public google::protobuf::Closure, private LoopTask {
+ public:
+  // Loop thread of `connection`. The request and response messages of the
+  // previous call are cleared and reused when the method types match and
+  // they were small enough to be kept.
+  // `id` goes into the envelope and `request_id` into the frame header.
+  static ResponseClosure* Acquire(
+      const std::shared_ptr<TcpConnection>& connection, uint32_t id,
+      uint64_t request_id,
+      const google::protobuf::Message& request_prototype,
+      const google::protobuf::Message& response_prototype);
+
+  ResponseClosure(const ResponseClosure&) = delete;
+  ResponseClosure& operator=(const ResponseClosure&) = delete;
+
+  google::protobuf::Message* request() const { return request_.get(); }
+  google::protobuf::Message* response() const { return response_.get(); }
+
+  // Any thread, exactly once per Acquire().
+  void Run() override;
+
+  // Loop thread, instead of Run() for a call that never reached its
+  // method: returns to the pool without sending anything.
+  void Release();
+
+  // Closures in the pool of the calling thread, and the message memory
+  // they keep.
+  static size_t pooled_count();
+  static size_t pooled_bytes();
+
+ private:
+  ResponseClosure() = default;
+
+  // Loop thread: sends the serialized response and returns to the pool.
+  void Finish();
+
+  void RunTask() override { Finish(); }
+
+  // Loop thread: back to the pool, or deleted if it is full.
+  void Recycle();
+
+  // The whole response in the configured envelope, envelope_size_ bytes.
+  void SerializeResponse(
+      google::protobuf::io::ZeroCopyOutputStream* output) const;
+
+  EventLoop* loop_ = nullptr;
+  std::weak_ptr<TcpConnection> connection_;
+
+  std::unique_ptr<google::protobuf::Message> request_;
+  std::unique_ptr<google::protobuf::Message> response_;
+
+  // The envelope without its response field, which is serialized in place
+  // behind it. Sizes are cached by Run().
+  rpc::RpcMessage response_message_;
+  // Used instead with the compact envelope.
+  CompactEnvelope compact_envelope_;
+  FrameHeader response_header_;
+  size_t response_size_ = 0;
+  size_t envelope_size_ = 0;
+  // Memory held by request_ and response_, measured by Run().
+  size_t message_bytes_ = 0;
+  // The serialized envelope of responses above the chain threshold.
+  IoBuf chain_;
+};
+
+#endif  //PHOTONRPC_RESPONSE_CLOSURE_H
@@ -3,13 +3,26 @@
 
 #include <google/protobuf/service.h>
 
+#include <memory>
+
+class RpcClient;
+
+// NOTE: keep the data members in sync with include/photonrpc/rpc.h.
 class RpcChannel : public google::protobuf::RpcChannel {
  public:
+  RpcChannel();
+
+  ~RpcChannel() override;
+
   void CallMethod(const google::protobuf::MethodDescriptor* method,
                   google::protobuf::RpcController* controller,
                   const google::protobuf::Message* request,
                   google::protobuf::Message* response,
                   google::protobuf::Closure* done) override;
+
+ private:
+  // Long-lived connection shared by every call made through this channel.
+  std::unique_ptr<RpcClient> client_;
 };
 
 #endif  //PHOTONRPC_RPC_CHANNEL_H
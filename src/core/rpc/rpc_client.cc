@@ -0,0 +1,315 @@
+#include "rpc_client.h"
+#include "photonrpc/rpc_message.pb.h"
+#include "../common/config.h"
+#include "rpc_codec.h"
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <algorithm>
+
+namespace {
+void NotifyFinished(std::promise<void>* finished) {
+  finished->set_value();
+}
+}  // namespace
+
+RpcClient::RpcClient()
+    : server_host_(Config::GetInstance().server_host()),
+      server_port_(Config::GetInstance().server_port()),
+      handshake_enabled_(Config::GetInstance().server_method_handshake()),
+      next_id_(1),
+      generation_(0),
+      tcp_client_(
+          TcpClient::DefaultLoop(),
+          [this](const FrameHeader& header, const IoBuf& message) {
+            this->HandleMessage(header, message);
+          },
+          [this](bool connected) { this->HandleConnect(connected); },
+          [this] { this->HandleClose(); }) {}
+
+void RpcClient::CallMethod(const google::protobuf::MethodDescriptor* method,
+                           google::protobuf::RpcController* controller,
+                           const google::protobuf::Message* request,
+                           google::protobuf::Message* response,
+                           google::protobuf::Closure* done) {
+  // A blocking call is an asynchronous one that wakes the caller when done.
+  std::promise<void> finished;
+  bool blocking = done == nullptr;
+  if (blocking) {
+    done = google::protobuf::NewCallback(&NotifyFinished, &finished);
+  }
+
+  PendingCall call{response, controller, done};
+  uint32_t method_id = kUnknownMethodId;
+  uint64_t generation;
+  bool handshake = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation = generation_;
+    if (handshake_enabled_ && tcp_client_.connected()) {
+      auto iter = method_ids_.find(method);
+      if (iter != method_ids_.end()) {
+        method_id = iter->second;
+      } else {
+        handshake = handshake_services_.insert(method->service()).second;
+      }
+    }
+  }
+  // Calls made before the reply still go by name.
+  if (handshake) {
+    SendHandshake(method->service(), generation);
+  }
+
+  uint32_t id = next_id_++;
+  std::string data = SerializeRequest(id, method, method_id, *request);
+
+  bool stale;
+  bool connect = false;
+  do {
+    stale = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (method_id != kUnknownMethodId && generation_ != generation) {
+        // An ID is only good on the connection that assigned it.
+        stale = true;
+      } else if (tcp_client_.connected()) {
+        pending_calls_.emplace(id, call);
+      } else {
+        // Sent from the loop thread once connected; nobody blocks on it.
+        connecting_calls_.push_back({id, std::move(data), call});
+        connect = true;
+      }
+    }
+    if (stale) {
+      // The connection may already be back; names are good on any one.
+      method_id = kUnknownMethodId;
+      data = SerializeRequest(id, method, method_id, *request);
+    }
+  } while (stale);
+  if (connect) {
+    tcp_client_.Connect(server_host_, server_port_);
+  } else {
+    FrameHeader header;
+    header.request_id = id;
+    tcp_client_.Send(std::move(data), header);
+  }
+
+  if (blocking) {
+    finished.get_future().wait();
+  }
+}
+
+void RpcClient::SendHandshake(
+    const google::protobuf::ServiceDescriptor* service, uint64_t generation) {
+  rpc::HandshakeRequest handshake;
+  for (int i = 0; i < service->method_count(); i++) {
+    handshake.add_method_names(service->method(i)->full_name());
+  }
+  uint32_t id = next_id_++;
+  std::string data;
+  if (UseCompactEnvelope()) {
+    CompactEnvelope envelope;
+    envelope.type = rpc::RPC_TYPE_HANDSHAKE;
+    envelope.id = id;
+    data.resize(kCompactEnvelopeSize);
+    EncodeCompactEnvelope(envelope, data.data());
+    data += handshake.SerializeAsString();
+  } else {
+    rpc::RpcMessage rpc_message;
+    rpc_message.set_id(id);
+    rpc_message.set_type(rpc::RPC_TYPE_HANDSHAKE);
+    rpc_message.set_request(handshake.SerializeAsString());
+    data = rpc_message.SerializeAsString();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Lost meanwhile; the next call on a new connection asks again.
+    if (!tcp_client_.connected() || generation_ != generation) {
+      return;
+    }
+    pending_handshakes_.emplace(id, service);
+  }
+  FrameHeader header;
+  header.request_id = id;
+  tcp_client_.Send(std::move(data), header);
+}
+
+void RpcClient::ApplyHandshake(
+    const google::protobuf::ServiceDescriptor* service, const IoBuf& message,
+    size_t payload_offset, size_t payload_size) {
+  rpc::HandshakeResponse response;
+  if (!ParseMessage(message, payload_offset, payload_size, &response)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  int count = std::min(service->method_count(), response.method_ids_size());
+  for (int i = 0; i < count; i++) {
+    if (response.method_ids(i) != kUnknownMethodId) {
+      method_ids_[service->method(i)] = response.method_ids(i);
+    }
+  }
+}
+
+std::string RpcClient::SerializeRequest(
+    uint32_t id, const google::protobuf::MethodDescriptor* method,
+    uint32_t method_id, const google::protobuf::Message& request) {
+  // The request is serialized in place behind the envelope.
+  size_t request_size = request.ByteSizeLong();
+  if (UseCompactEnvelope()) {
+    CompactEnvelope envelope;
+    envelope.type = rpc::RPC_TYPE_REQUEST;
+    envelope.id = id;
+    if (method_id != kUnknownMethodId) {
+      envelope.flags = kEnvelopeMethodId;
+      envelope.method_key = method_id;
+    } else {
+      envelope.method_key = MethodKey(method->full_name());
+    }
+    std::string data(kCompactEnvelopeSize + request_size, '\0');
+    google::protobuf::io::ArrayOutputStream output(
+        data.data(), static_cast<int>(data.size()));
+    SerializeCompact(envelope, request, &output);
+    return data;
+  }
+
+  rpc::RpcMessage rpc_message;
+  rpc_message.set_id(id);
+  rpc_message.set_type(rpc::RPC_TYPE_REQUEST);
+  if (method_id != kUnknownMethodId) {
+    rpc_message.set_method_id(method_id);
+  } else {
+    rpc_message.set_service_name(method->service()->name());
+    rpc_message.set_method_name(method->name());
+  }
+  std::string data(EnvelopeSize(rpc_message,
+                                rpc::RpcMessage::kRequestFieldNumber,
+                                request_size),
+                   '\0');
+  google::protobuf::io::ArrayOutputStream output(
+      data.data(), static_cast<int>(data.size()));
+  SerializeEnvelope(rpc_message, rpc::RpcMessage::kRequestFieldNumber,
+                    request, request_size, &output);
+  return data;
+}
+
+void RpcClient::HandleMessage(const FrameHeader& header,
+                              const IoBuf& message) {
+  uint32_t envelope_id;
+  int envelope_type;
+  bool envelope_failed;
+  size_t payload_offset;
+  size_t payload_size;
+  if (UseCompactEnvelope()) {
+    CompactEnvelope envelope;
+    if (!DecodeCompactEnvelope(message, &envelope)) {
+      return;
+    }
+    envelope_id = envelope.id;
+    envelope_type = envelope.type;
+    envelope_failed = envelope.status != kStatusOk;
+    payload_offset = kCompactEnvelopeSize;
+    payload_size = message.size() - kCompactEnvelopeSize;
+  } else {
+    rpc::RpcMessage rpc_message;
+    if (!ParseEnvelope(message, rpc::RpcMessage::kResponseFieldNumber,
+                       &rpc_message, &payload_offset, &payload_size)) {
+      return;
+    }
+    envelope_id = rpc_message.id();
+    envelope_type = rpc_message.type();
+    envelope_failed = rpc_message.type() != rpc::RPC_TYPE_RESPONSE &&
+                      rpc_message.type() != rpc::RPC_TYPE_HANDSHAKE;
+  }
+  // v2 frames name the call and its outcome in the frame header, which
+  // also covers error replies to envelopes the server couldn't parse.
+  bool has_header = (header.flags & Codec::kFlagResponse) != 0;
+  uint64_t id = has_header ? header.request_id : envelope_id;
+  bool failed =
+      has_header ? (header.flags & Codec::kFlagError) != 0 : envelope_failed;
+
+  PendingCall call{};
+  const google::protobuf::ServiceDescriptor* handshake_service = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto handshake = pending_handshakes_.find(static_cast<uint32_t>(id));
+    if (handshake != pending_handshakes_.end()) {
+      handshake_service = handshake->second;
+      pending_handshakes_.erase(handshake);
+    } else {
+      auto iter = pending_calls_.find(static_cast<uint32_t>(id));
+      if (iter == pending_calls_.end()) {
+        // LOG_WARN("Response for unknown call id: {}", id);
+        return;
+      }
+      call = iter->second;
+      pending_calls_.erase(iter);
+    }
+  }
+
+  if (handshake_service != nullptr) {
+    // A server without handshakes rejects it, and names keep working.
+    if (!failed && envelope_type == rpc::RPC_TYPE_HANDSHAKE) {
+      ApplyHandshake(handshake_service, message, payload_offset,
+                     payload_size);
+    }
+    return;
+  }
+
+  if (!failed) {
+    if (!ParseMessage(message, payload_offset, payload_size, call.response)) {
+      FailCall(call, "invalid response");
+      return;
+    }
+    call.done->Run();
+  } else {
+    std::string reason(payload_size, '\0');
+    message.CopyTo(payload_offset, payload_size, reason.data());
+    FailCall(call, reason);
+  }
+}
+
+void RpcClient::HandleConnect(bool connected) {
+  std::vector<ConnectingCall> calls;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    calls.swap(connecting_calls_);
+    if (connected) {
+      for (ConnectingCall& call : calls) {
+        pending_calls_.emplace(call.id, call.call);
+      }
+    }
+  }
+  for (ConnectingCall& call : calls) {
+    if (connected) {
+      FrameHeader header;
+      header.request_id = call.id;
+      tcp_client_.Send(std::move(call.data), header);
+    } else {
+      FailCall(call.call, "connect failed");
+    }
+  }
+}
+
+void RpcClient::HandleClose() {
+  std::unordered_map<uint32_t, PendingCall> failed_calls;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failed_calls.swap(pending_calls_);
+    // The next server may number its methods differently.
+    generation_++;
+    method_ids_.clear();
+    handshake_services_.clear();
+    pending_handshakes_.clear();
+  }
+  for (auto& [id, call] : failed_calls) {
+    FailCall(call, "connection closed");
+  }
+}
+
+void RpcClient::FailCall(const PendingCall& call, const std::string& reason) {
+  if (call.controller != nullptr) {
+    call.controller->SetFailed(reason);
+  }
+  call.done->Run();
+}
@@ -0,0 +1,102 @@
+#ifndef PHOTONRPC_RPC_CLIENT_H
+#define PHOTONRPC_RPC_CLIENT_H
+
+#include <google/protobuf/service.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../net/tcp_client.h"
+
+// RpcChannel背后的长连接客户端
+// 多个并发调用复用同一条TCP连接，响应按RpcMessage.id与调用匹配
+class RpcClient {
+ public:
+  RpcClient();
+
+  // Thread-safe. Without `done` the call blocks until the response arrives
+  // or the call fails. With `done` it returns once the request is queued and
+  // `done` runs in the client loop thread when the call finishes, so it must
+  // not make blocking calls itself.
+  void CallMethod(const google::protobuf::MethodDescriptor* method,
+                  google::protobuf::RpcController* controller,
+                  const google::protobuf::Message* request,
+                  google::protobuf::Message* response,
+                  google::protobuf::Closure* done);
+
+ private:
+  struct PendingCall {
+    google::protobuf::Message* response;
+    google::protobuf::RpcController* controller;
+    google::protobuf::Closure* done;
+  };
+
+  // A call made while not connected, serialized by method name.
+  struct ConnectingCall {
+    uint32_t id;
+    std::string data;
+    PendingCall call;
+  };
+
+  // The request frame's body in the configured envelope, naming the method
+  // by `method_id` unless it is kUnknownMethodId.
+  static std::string SerializeRequest(
+      uint32_t id, const google::protobuf::MethodDescriptor* method,
+      uint32_t method_id, const google::protobuf::Message& request);
+
+  // Asks the server for the IDs of the methods of `service`, unless the
+  // connection of `generation` is gone.
+  void SendHandshake(const google::protobuf::ServiceDescriptor* service,
+                     uint64_t generation);
+
+  // Loop thread. Stores the IDs of the handshake reply.
+  void ApplyHandshake(const google::protobuf::ServiceDescriptor* service,
+                      const IoBuf& message, size_t payload_offset,
+                      size_t payload_size);
+
+  // Loop thread.
+  void HandleMessage(const FrameHeader& header, const IoBuf& message);
+
+  // Loop thread. Sends the calls queued during the connect, or fails them.
+  void HandleConnect(bool connected);
+
+  // Loop thread. Fails every call still waiting on the lost connection.
+  void HandleClose();
+
+  static void FailCall(const PendingCall& call, const std::string& reason);
+
+  std::string server_host_;
+  int server_port_;
+
+  // From server.method_handshake.
+  bool handshake_enabled_;
+
+  std::atomic<uint32_t> next_id_;
+
+  // Guards the calls together with the connection state, so a call is
+  // either registered before a close fails it or sees the close, and either
+  // queued before the connect finishes or sees it finished.
+  std::mutex mutex_;
+  std::unordered_map<uint32_t, PendingCall> pending_calls_;
+  std::vector<ConnectingCall> connecting_calls_;
+
+  // Method IDs learned on the current connection, the services whose
+  // handshake was sent, and the handshakes awaiting a reply by call id.
+  // All reset with the connection, which also bumps generation_.
+  std::unordered_map<const google::protobuf::MethodDescriptor*, uint32_t>
+      method_ids_;
+  std::unordered_set<const google::protobuf::ServiceDescriptor*>
+      handshake_services_;
+  std::unordered_map<uint32_t, const google::protobuf::ServiceDescriptor*>
+      pending_handshakes_;
+  uint64_t generation_;
+
+  // Last member: its destructor stops the callbacks into this object.
+  TcpClient tcp_client_;
+};
+
+#endif  //PHOTONRPC_RPC_CLIENT_H
@@ -0,0 +1,141 @@
+#include "rpc_codec.h"
+#include "../common/config.h"
+
+#include <endian.h>
+#include <string.h>
+
+namespace {
+const uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+
+// Continues an FNV-1a hash over `data`.
+uint64_t Fnv1a(uint64_t hash, std::string_view data) {
+  for (char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool ParseEnvelopeFields(google::protobuf::io::CodedInputStream* input,
+                         int payload_field, rpc::RpcMessage* envelope,
+                         size_t* payload_offset, size_t* payload_size) {
+  using google::protobuf::internal::WireFormatLite;
+  *payload_offset = 0;
+  *payload_size = 0;
+  while (uint32_t tag = input->ReadTag()) {
+    int field = WireFormatLite::GetTagFieldNumber(tag);
+    WireFormatLite::WireType wire_type = WireFormatLite::GetTagWireType(tag);
+    uint32_t value;
+    if (wire_type == WireFormatLite::WIRETYPE_VARINT &&
+        (field == rpc::RpcMessage::kIdFieldNumber ||
+         field == rpc::RpcMessage::kTypeFieldNumber ||
+         field == rpc::RpcMessage::kMethodIdFieldNumber)) {
+      if (!input->ReadVarint32(&value)) {
+        return false;
+      }
+      if (field == rpc::RpcMessage::kIdFieldNumber) {
+        envelope->set_id(value);
+      } else if (field == rpc::RpcMessage::kTypeFieldNumber) {
+        envelope->set_type(static_cast<rpc::MessageType>(value));
+      } else {
+        envelope->set_method_id(value);
+      }
+    } else if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED &&
+               field == payload_field) {
+      if (!input->ReadVarint32(&value)) {
+        return false;
+      }
+      *payload_offset = input->CurrentPosition();
+      *payload_size = value;
+      if (!input->Skip(static_cast<int>(value))) {
+        return false;
+      }
+    } else if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED &&
+               field == rpc::RpcMessage::kServiceNameFieldNumber) {
+      if (!WireFormatLite::ReadString(input,
+                                      envelope->mutable_service_name())) {
+        return false;
+      }
+    } else if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED &&
+               field == rpc::RpcMessage::kMethodNameFieldNumber) {
+      if (!WireFormatLite::ReadString(input,
+                                      envelope->mutable_method_name())) {
+        return false;
+      }
+    } else if (!WireFormatLite::SkipField(input, tag)) {
+      return false;
+    }
+  }
+  // Stopped by the end of the frame, not by a malformed tag.
+  return input->ConsumedEntireMessage();
+}
+}  // namespace
+
+bool ParseEnvelope(const IoBuf& frame, int payload_field,
+                   rpc::RpcMessage* envelope, size_t* payload_offset,
+                   size_t* payload_size) {
+  if (frame.segment_count() <= 1) {
+    std::string_view segment =
+        frame.segment_count() == 0 ? std::string_view() : frame.segment(0);
+    google::protobuf::io::CodedInputStream input(
+        reinterpret_cast<const uint8_t*>(segment.data()),
+        static_cast<int>(segment.size()));
+    return ParseEnvelopeFields(&input, payload_field, envelope,
+                               payload_offset, payload_size);
+  }
+  IoBufInputStream stream(frame);
+  google::protobuf::io::CodedInputStream input(&stream);
+  return ParseEnvelopeFields(&input, payload_field, envelope, payload_offset,
+                             payload_size);
+}
+
+bool UseCompactEnvelope() {
+  static const bool compact = Config::GetInstance().server_compact_envelope();
+  return compact;
+}
+
+uint64_t MethodKey(std::string_view full_name) {
+  return Fnv1a(kFnvOffsetBasis, full_name);
+}
+
+uint64_t MethodKey(std::string_view service_name,
+                   std::string_view method_name) {
+  return Fnv1a(Fnv1a(Fnv1a(kFnvOffsetBasis, service_name), "."), method_name);
+}
+
+void EncodeCompactEnvelope(const CompactEnvelope& envelope, char* dest) {
+  char fixed[kCompactEnvelopeSize] = {};
+  fixed[0] = static_cast<char>(envelope.type);
+  fixed[1] = static_cast<char>(envelope.status);
+  fixed[2] = static_cast<char>(envelope.flags);
+  // Typed locals and memcpy(), never wider pointers into char storage.
+  uint32_t id = htobe32(envelope.id);
+  uint64_t method_key = htobe64(envelope.method_key);
+  uint32_t deadline_ms = htobe32(envelope.deadline_ms);
+  memcpy(fixed + 4, &id, sizeof(id));
+  memcpy(fixed + 8, &method_key, sizeof(method_key));
+  memcpy(fixed + 16, &deadline_ms, sizeof(deadline_ms));
+  memcpy(dest, fixed, kCompactEnvelopeSize);
+}
+
+bool DecodeCompactEnvelope(const IoBuf& frame, CompactEnvelope* envelope) {
+  if (frame.size() < kCompactEnvelopeSize) {
+    return false;
+  }
+  // May straddle segments; copied out first, then one load per field.
+  char fixed[kCompactEnvelopeSize];
+  frame.CopyTo(0, kCompactEnvelopeSize, fixed);
+  uint32_t id;
+  uint64_t method_key;
+  uint32_t deadline_ms;
+  memcpy(&id, fixed + 4, sizeof(id));
+  memcpy(&method_key, fixed + 8, sizeof(method_key));
+  memcpy(&deadline_ms, fixed + 16, sizeof(deadline_ms));
+  envelope->type = static_cast<uint8_t>(fixed[0]);
+  envelope->status = static_cast<uint8_t>(fixed[1]);
+  envelope->flags = static_cast<uint8_t>(fixed[2]);
+  envelope->id = be32toh(id);
+  envelope->method_key = be64toh(method_key);
+  envelope->deadline_ms = be32toh(deadline_ms);
+  return true;
+}
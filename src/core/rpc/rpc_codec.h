@@ -0,0 +1,144 @@
+#ifndef PHOTONRPC_RPC_CODEC_H
+#define PHOTONRPC_RPC_CODEC_H
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <cstdint>
+#include <string_view>
+
+#include "photonrpc/rpc_message.pb.h"
+#include "../net/io_buf.h"
+#include "io_buf_stream.h"
+
+// Parses a message straight from the received frame. A frame in one piece
+// takes the flat-array fast path, others are read segment by segment.
+inline bool ParseMessage(const IoBuf& data,
+                         google::protobuf::Message* message) {
+  if (data.segment_count() <= 1) {
+    std::string_view segment =
+        data.segment_count() == 0 ? std::string_view() : data.segment(0);
+    return message->ParseFromArray(segment.data(),
+                                   static_cast<int>(segment.size()));
+  }
+  IoBufInputStream stream(data);
+  return message->ParseFromZeroCopyStream(&stream);
+}
+
+// Same, for the bytes [offset, offset + size) of the frame.
+inline bool ParseMessage(const IoBuf& data, size_t offset, size_t size,
+                         google::protobuf::Message* message) {
+  if (data.segment_count() == 1) {
+    std::string_view segment = data.segment(0);
+    return message->ParseFromArray(segment.data() + offset,
+                                   static_cast<int>(size));
+  }
+  IoBufInputStream stream(data);
+  return stream.Skip(static_cast<int>(offset)) &&
+         message->ParseFromBoundedZeroCopyStream(&stream,
+                                                 static_cast<int>(size));
+}
+
+// Parses the envelope of a frame, except for the bytes field
+// `payload_field` (request or response): only its place in the frame is
+// stored, so the payload can be parsed from there with ParseMessage()
+// instead of being copied into the envelope first. A missing payload has
+// size 0.
+bool ParseEnvelope(const IoBuf& frame, int payload_field,
+                   rpc::RpcMessage* envelope, size_t* payload_offset,
+                   size_t* payload_size);
+
+// Size of `envelope` carrying a `payload_size`-byte payload in the bytes
+// field `field_number` (request or response). Also caches the sizes that
+// SerializeEnvelope() relies on.
+inline size_t EnvelopeSize(const rpc::RpcMessage& envelope, int field_number,
+                           size_t payload_size) {
+  using google::protobuf::internal::WireFormatLite;
+  size_t size = envelope.ByteSizeLong();
+  if (payload_size > 0) {
+    size += WireFormatLite::TagSize(field_number, WireFormatLite::TYPE_BYTES) +
+            google::protobuf::io::CodedOutputStream::VarintSize64(
+                payload_size) +
+            payload_size;
+  }
+  return size;
+}
+
+// Writes what serializing `envelope` with `payload` in field `field_number`
+// would, but the payload goes straight to `output` instead of through the
+// bytes field. That field of `envelope` must be empty and, as it is the
+// last one, comes out in the same place, unless method_id is set, which
+// then precedes it. Needs the sizes cached by EnvelopeSize() and
+// payload.ByteSizeLong().
+inline void SerializeEnvelope(
+    const rpc::RpcMessage& envelope, int field_number,
+    const google::protobuf::Message& payload, size_t payload_size,
+    google::protobuf::io::ZeroCopyOutputStream* output) {
+  using google::protobuf::internal::WireFormatLite;
+  google::protobuf::io::CodedOutputStream coded(output);
+  envelope.SerializeWithCachedSizes(&coded);
+  if (payload_size > 0) {
+    WireFormatLite::WriteTag(field_number,
+                             WireFormatLite::WIRETYPE_LENGTH_DELIMITED, &coded);
+    coded.WriteVarint32(static_cast<uint32_t>(payload_size));
+    payload.SerializeWithCachedSizes(&coded);
+  }
+}
+
+// 紧凑信封：24字节定长二进制头部，后面直接是用户消息
+// 方法用method_key（方法全名的FNV-1a哈希）标识，负载不再嵌套进RpcMessage的bytes字段
+// 网络字节序，各字段自然对齐：
+//   0 type(1) | 1 status(1) | 2 flags(1) | 3 reserved(1) | 4 id(4)
+//   8 method_key(8) | 16 deadline_ms(4) | 20 reserved(4)
+struct CompactEnvelope {
+  uint8_t type = rpc::RPC_TYPE_UNKNOW;  // rpc::MessageType.
+  uint8_t status = 0;                   // kStatusOk or why it failed.
+  uint8_t flags = 0;                    // kEnvelope* bits.
+  uint32_t id = 0;
+  // Requests only: MethodKey() of the method, or with kEnvelopeMethodId
+  // the id the handshake assigned to it.
+  uint64_t method_key = 0;
+  // Time budget of a request from when it was sent, 0 for none.
+  uint32_t deadline_ms = 0;
+};
+
+constexpr size_t kCompactEnvelopeSize = 24;
+
+constexpr uint8_t kEnvelopeMethodId = 1 << 0;
+
+// In rpc::HandshakeResponse, for a method the server doesn't serve.
+constexpr uint32_t kUnknownMethodId = 0xffffffff;
+
+constexpr uint8_t kStatusOk = 0;
+constexpr uint8_t kStatusInvalidRequest = 1;
+
+// Whether both ends use CompactEnvelope instead of rpc::RpcMessage, set by
+// server.envelope in the config.
+bool UseCompactEnvelope();
+
+// FNV-1a over the method's full name, e.g. "rpc.EchoService.Echo".
+uint64_t MethodKey(std::string_view full_name);
+
+// MethodKey() of "<service_name>.<method_name>", without building it.
+uint64_t MethodKey(std::string_view service_name,
+                   std::string_view method_name);
+
+void EncodeCompactEnvelope(const CompactEnvelope& envelope, char* dest);
+
+// Reads the envelope at the front of `frame`; false if it is too short.
+bool DecodeCompactEnvelope(const IoBuf& frame, CompactEnvelope* envelope);
+
+// Writes `envelope` with `payload` right behind it to `output`. Needs the
+// size cached by payload.ByteSizeLong().
+inline void SerializeCompact(
+    const CompactEnvelope& envelope, const google::protobuf::Message& payload,
+    google::protobuf::io::ZeroCopyOutputStream* output) {
+  char encoded[kCompactEnvelopeSize];
+  EncodeCompactEnvelope(envelope, encoded);
+  google::protobuf::io::CodedOutputStream coded(output);
+  coded.WriteRaw(encoded, kCompactEnvelopeSize);
+  payload.SerializeWithCachedSizes(&coded);
+}
+
+#endif  //PHOTONRPC_RPC_CODEC_H
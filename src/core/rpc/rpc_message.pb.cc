@@ -23,13 +23,15 @@ namespace _pbi = _pb::internal;
 namespace rpc {
 PROTOBUF_CONSTEXPR RpcMessage::RpcMessage(
     ::_pbi::ConstantInitialized): _impl_{
-    /*decltype(_impl_.service_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+    /*decltype(_impl_._has_bits_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}
+  , /*decltype(_impl_.service_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.method_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.request_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.response_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
   , /*decltype(_impl_.id_)*/0u
   , /*decltype(_impl_.type_)*/0
-  , /*decltype(_impl_._cached_size_)*/{}} {}
+  , /*decltype(_impl_.method_id_)*/0u} {}
 struct RpcMessageDefaultTypeInternal {
   PROTOBUF_CONSTEXPR RpcMessageDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -39,13 +41,40 @@ struct RpcMessageDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 RpcMessageDefaultTypeInternal _RpcMessage_default_instance_;
+PROTOBUF_CONSTEXPR HandshakeRequest::HandshakeRequest(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.method_names_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct HandshakeRequestDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR HandshakeRequestDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~HandshakeRequestDefaultTypeInternal() {}
+  union {
+    HandshakeRequest _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 HandshakeRequestDefaultTypeInternal _HandshakeRequest_default_instance_;
+PROTOBUF_CONSTEXPR HandshakeResponse::HandshakeResponse(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.method_ids_)*/{}
+  , /*decltype(_impl_._method_ids_cached_byte_size_)*/{0}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct HandshakeResponseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR HandshakeResponseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~HandshakeResponseDefaultTypeInternal() {}
+  union {
+    HandshakeResponse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 HandshakeResponseDefaultTypeInternal _HandshakeResponse_default_instance_;
 }  // namespace rpc
-static ::_pb::Metadata file_level_metadata_rpc_5fmessage_2eproto[1];
+static ::_pb::Metadata file_level_metadata_rpc_5fmessage_2eproto[3];
 static const ::_pb::EnumDescriptor* file_level_enum_descriptors_rpc_5fmessage_2eproto[1];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_rpc_5fmessage_2eproto = nullptr;
 
 const uint32_t TableStruct_rpc_5fmessage_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
-  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::rpc::RpcMessage, _impl_._has_bits_),
   PROTOBUF_FIELD_OFFSET(::rpc::RpcMessage, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
@@ -57,29 +86,59 @@ const uint32_t TableStruct_rpc_5fmessage_2eproto::offsets[] PROTOBUF_SECTION_VAR
   PROTOBUF_FIELD_OFFSET(::rpc::RpcMessage, _impl_.method_name_),
   PROTOBUF_FIELD_OFFSET(::rpc::RpcMessage, _impl_.request_),
   PROTOBUF_FIELD_OFFSET(::rpc::RpcMessage, _impl_.response_),
+  PROTOBUF_FIELD_OFFSET(::rpc::RpcMessage, _impl_.method_id_),
+  ~0u,
+  ~0u,
+  ~0u,
+  ~0u,
+  ~0u,
+  ~0u,
+  0,
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::rpc::HandshakeRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::rpc::HandshakeRequest, _impl_.method_names_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::rpc::HandshakeResponse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::rpc::HandshakeResponse, _impl_.method_ids_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
-  { 0, -1, -1, sizeof(::rpc::RpcMessage)},
+  { 0, 13, -1, sizeof(::rpc::RpcMessage)},
+  { 20, -1, -1, sizeof(::rpc::HandshakeRequest)},
+  { 27, -1, -1, sizeof(::rpc::HandshakeResponse)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
   &::rpc::_RpcMessage_default_instance_._instance,
+  &::rpc::_HandshakeRequest_default_instance_._instance,
+  &::rpc::_HandshakeResponse_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_rpc_5fmessage_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
-  "\n\021rpc_message.proto\022\003rpc\"\206\001\n\nRpcMessage\022"
+  "\n\021rpc_message.proto\022\003rpc\"\254\001\n\nRpcMessage\022"
   "\n\n\002id\030\001 \001(\r\022\036\n\004type\030\002 \001(\0162\020.rpc.MessageT"
   "ype\022\024\n\014service_name\030\003 \001(\t\022\023\n\013method_name"
   "\030\004 \001(\t\022\017\n\007request\030\005 \001(\014\022\020\n\010response\030\006 \001("
-  "\014*c\n\013MessageType\022\023\n\017RPC_TYPE_UNKNOW\020\000\022\024\n"
-  "\020RPC_TYPE_REQUEST\020\001\022\025\n\021RPC_TYPE_RESPONSE"
-  "\020\002\022\022\n\016RPC_TYPE_ERROR\020\003b\006proto3"
+  "\014\022\026\n\tmethod_id\030\007 \001(\rH\000\210\001\001B\014\n\n_method_id\""
+  "(\n\020HandshakeRequest\022\024\n\014method_names\030\001 \003("
+  "\t\"\'\n\021HandshakeResponse\022\022\n\nmethod_ids\030\001 \003"
+  "(\r*{\n\013MessageType\022\023\n\017RPC_TYPE_UNKNOW\020\000\022\024"
+  "\n\020RPC_TYPE_REQUEST\020\001\022\025\n\021RPC_TYPE_RESPONS"
+  "E\020\002\022\022\n\016RPC_TYPE_ERROR\020\003\022\026\n\022RPC_TYPE_HAND"
+  "SHAKE\020\004b\006proto3"
   ;
 static ::_pbi::once_flag descriptor_table_rpc_5fmessage_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_rpc_5fmessage_2eproto = {
-    false, false, 270, descriptor_table_protodef_rpc_5fmessage_2eproto,
+    false, false, 415, descriptor_table_protodef_rpc_5fmessage_2eproto,
     "rpc_message.proto",
-    &descriptor_table_rpc_5fmessage_2eproto_once, nullptr, 0, 1,
+    &descriptor_table_rpc_5fmessage_2eproto_once, nullptr, 0, 3,
     schemas, file_default_instances, TableStruct_rpc_5fmessage_2eproto::offsets,
     file_level_metadata_rpc_5fmessage_2eproto, file_level_enum_descriptors_rpc_5fmessage_2eproto,
     file_level_service_descriptors_rpc_5fmessage_2eproto,
@@ -101,6 +160,7 @@ bool MessageType_IsValid(int value) {
     case 1:
     case 2:
     case 3:
+    case 4:
       return true;
     default:
       return false;
@@ -112,6 +172,10 @@ bool MessageType_IsValid(int value) {
 
 class RpcMessage::_Internal {
  public:
+  using HasBits = decltype(std::declval<RpcMessage>()._impl_._has_bits_);
+  static void set_has_method_id(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
 };
 
 RpcMessage::RpcMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
@@ -124,13 +188,15 @@ RpcMessage::RpcMessage(const RpcMessage& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
   RpcMessage* const _this = this; (void)_this;
   new (&_impl_) Impl_{
-      decltype(_impl_.service_name_){}
+      decltype(_impl_._has_bits_){from._impl_._has_bits_}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.service_name_){}
     , decltype(_impl_.method_name_){}
     , decltype(_impl_.request_){}
     , decltype(_impl_.response_){}
     , decltype(_impl_.id_){}
     , decltype(_impl_.type_){}
-    , /*decltype(_impl_._cached_size_)*/{}};
+    , decltype(_impl_.method_id_){}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   _impl_.service_name_.InitDefault();
@@ -166,8 +232,8 @@ RpcMessage::RpcMessage(const RpcMessage& from)
       _this->GetArenaForAllocation());
   }
   ::memcpy(&_impl_.id_, &from._impl_.id_,
-    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.type_) -
-    reinterpret_cast<char*>(&_impl_.id_)) + sizeof(_impl_.type_));
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.method_id_) -
+    reinterpret_cast<char*>(&_impl_.id_)) + sizeof(_impl_.method_id_));
   // @@protoc_insertion_point(copy_constructor:rpc.RpcMessage)
 }
 
@@ -176,13 +242,15 @@ inline void RpcMessage::SharedCtor(
   (void)arena;
   (void)is_message_owned;
   new (&_impl_) Impl_{
-      decltype(_impl_.service_name_){}
+      decltype(_impl_._has_bits_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.service_name_){}
     , decltype(_impl_.method_name_){}
     , decltype(_impl_.request_){}
     , decltype(_impl_.response_){}
     , decltype(_impl_.id_){0u}
     , decltype(_impl_.type_){0}
-    , /*decltype(_impl_._cached_size_)*/{}
+    , decltype(_impl_.method_id_){0u}
   };
   _impl_.service_name_.InitDefault();
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
@@ -236,11 +304,14 @@ void RpcMessage::Clear() {
   ::memset(&_impl_.id_, 0, static_cast<size_t>(
       reinterpret_cast<char*>(&_impl_.type_) -
       reinterpret_cast<char*>(&_impl_.id_)) + sizeof(_impl_.type_));
+  _impl_.method_id_ = 0u;
+  _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
 const char* RpcMessage::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
 #define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
   while (!ctx->Done(&ptr)) {
     uint32_t tag;
     ptr = ::_pbi::ReadTag(ptr, &tag);
@@ -300,6 +371,15 @@ const char* RpcMessage::_InternalParse(const char* ptr, ::_pbi::ParseContext* ct
         } else
           goto handle_unusual;
         continue;
+      // optional uint32 method_id = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _Internal::set_has_method_id(&has_bits);
+          _impl_.method_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -316,6 +396,7 @@ const char* RpcMessage::_InternalParse(const char* ptr, ::_pbi::ParseContext* ct
     CHK_(ptr != nullptr);
   }  // while
 message_done:
+  _impl_._has_bits_.Or(has_bits);
   return ptr;
 failure:
   ptr = nullptr;
@@ -374,6 +455,12 @@ uint8_t* RpcMessage::_InternalSerialize(
         6, this->_internal_response(), target);
   }
 
+  // optional uint32 method_id = 7;
+  if (_internal_has_method_id()) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt32ToArray(7, this->_internal_method_id(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -429,6 +516,12 @@ size_t RpcMessage::ByteSizeLong() const {
       ::_pbi::WireFormatLite::EnumSize(this->_internal_type());
   }
 
+  // optional uint32 method_id = 7;
+  cached_has_bits = _impl_._has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(this->_internal_method_id());
+  }
+
   return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
@@ -465,6 +558,9 @@ void RpcMessage::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PRO
   if (from._internal_type() != 0) {
     _this->_internal_set_type(from._internal_type());
   }
+  if (from._internal_has_method_id()) {
+    _this->_internal_set_method_id(from._internal_method_id());
+  }
   _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
@@ -484,6 +580,7 @@ void RpcMessage::InternalSwap(RpcMessage* other) {
   auto* lhs_arena = GetArenaForAllocation();
   auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
       &_impl_.service_name_, lhs_arena,
       &other->_impl_.service_name_, rhs_arena
@@ -501,8 +598,8 @@ void RpcMessage::InternalSwap(RpcMessage* other) {
       &other->_impl_.response_, rhs_arena
   );
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(RpcMessage, _impl_.type_)
-      + sizeof(RpcMessage::_impl_.type_)
+      PROTOBUF_FIELD_OFFSET(RpcMessage, _impl_.method_id_)
+      + sizeof(RpcMessage::_impl_.method_id_)
       - PROTOBUF_FIELD_OFFSET(RpcMessage, _impl_.id_)>(
           reinterpret_cast<char*>(&_impl_.id_),
           reinterpret_cast<char*>(&other->_impl_.id_));
@@ -514,6 +611,389 @@ void RpcMessage::InternalSwap(RpcMessage* other) {
       file_level_metadata_rpc_5fmessage_2eproto[0]);
 }
 
+// ===================================================================
+
+class HandshakeRequest::_Internal {
+ public:
+};
+
+HandshakeRequest::HandshakeRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:rpc.HandshakeRequest)
+}
+HandshakeRequest::HandshakeRequest(const HandshakeRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  HandshakeRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.method_names_){from._impl_.method_names_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:rpc.HandshakeRequest)
+}
+
+inline void HandshakeRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.method_names_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+HandshakeRequest::~HandshakeRequest() {
+  // @@protoc_insertion_point(destructor:rpc.HandshakeRequest)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void HandshakeRequest::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.method_names_.~RepeatedPtrField();
+}
+
+void HandshakeRequest::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void HandshakeRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:rpc.HandshakeRequest)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.method_names_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* HandshakeRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated string method_names = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            auto str = _internal_add_method_names();
+            ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+            CHK_(ptr);
+            CHK_(::_pbi::VerifyUTF8(str, "rpc.HandshakeRequest.method_names"));
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* HandshakeRequest::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:rpc.HandshakeRequest)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated string method_names = 1;
+  for (int i = 0, n = this->_internal_method_names_size(); i < n; i++) {
+    const auto& s = this->_internal_method_names(i);
+    ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::VerifyUtf8String(
+      s.data(), static_cast<int>(s.length()),
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::SERIALIZE,
+      "rpc.HandshakeRequest.method_names");
+    target = stream->WriteString(1, s, target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:rpc.HandshakeRequest)
+  return target;
+}
+
+size_t HandshakeRequest::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:rpc.HandshakeRequest)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated string method_names = 1;
+  total_size += 1 *
+      ::PROTOBUF_NAMESPACE_ID::internal::FromIntSize(_impl_.method_names_.size());
+  for (int i = 0, n = _impl_.method_names_.size(); i < n; i++) {
+    total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+      _impl_.method_names_.Get(i));
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData HandshakeRequest::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    HandshakeRequest::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*HandshakeRequest::GetClassData() const { return &_class_data_; }
+
+
+void HandshakeRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<HandshakeRequest*>(&to_msg);
+  auto& from = static_cast<const HandshakeRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:rpc.HandshakeRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.method_names_.MergeFrom(from._impl_.method_names_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void HandshakeRequest::CopyFrom(const HandshakeRequest& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:rpc.HandshakeRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool HandshakeRequest::IsInitialized() const {
+  return true;
+}
+
+void HandshakeRequest::InternalSwap(HandshakeRequest* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.method_names_.InternalSwap(&other->_impl_.method_names_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata HandshakeRequest::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_rpc_5fmessage_2eproto_getter, &descriptor_table_rpc_5fmessage_2eproto_once,
+      file_level_metadata_rpc_5fmessage_2eproto[1]);
+}
+
+// ===================================================================
+
+class HandshakeResponse::_Internal {
+ public:
+};
+
+HandshakeResponse::HandshakeResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:rpc.HandshakeResponse)
+}
+HandshakeResponse::HandshakeResponse(const HandshakeResponse& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  HandshakeResponse* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.method_ids_){from._impl_.method_ids_}
+    , /*decltype(_impl_._method_ids_cached_byte_size_)*/{0}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:rpc.HandshakeResponse)
+}
+
+inline void HandshakeResponse::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.method_ids_){arena}
+    , /*decltype(_impl_._method_ids_cached_byte_size_)*/{0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+HandshakeResponse::~HandshakeResponse() {
+  // @@protoc_insertion_point(destructor:rpc.HandshakeResponse)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void HandshakeResponse::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.method_ids_.~RepeatedField();
+}
+
+void HandshakeResponse::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void HandshakeResponse::Clear() {
+// @@protoc_insertion_point(message_clear_start:rpc.HandshakeResponse)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.method_ids_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* HandshakeResponse::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated uint32 method_ids = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedUInt32Parser(_internal_mutable_method_ids(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 8) {
+          _internal_add_method_ids(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* HandshakeResponse::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:rpc.HandshakeResponse)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated uint32 method_ids = 1;
+  {
+    int byte_size = _impl_._method_ids_cached_byte_size_.load(std::memory_order_relaxed);
+    if (byte_size > 0) {
+      target = stream->WriteUInt32Packed(
+          1, _internal_method_ids(), byte_size, target);
+    }
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:rpc.HandshakeResponse)
+  return target;
+}
+
+size_t HandshakeResponse::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:rpc.HandshakeResponse)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated uint32 method_ids = 1;
+  {
+    size_t data_size = ::_pbi::WireFormatLite::
+      UInt32Size(this->_impl_.method_ids_);
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    int cached_size = ::_pbi::ToCachedSize(data_size);
+    _impl_._method_ids_cached_byte_size_.store(cached_size,
+                                    std::memory_order_relaxed);
+    total_size += data_size;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData HandshakeResponse::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    HandshakeResponse::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*HandshakeResponse::GetClassData() const { return &_class_data_; }
+
+
+void HandshakeResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<HandshakeResponse*>(&to_msg);
+  auto& from = static_cast<const HandshakeResponse&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:rpc.HandshakeResponse)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.method_ids_.MergeFrom(from._impl_.method_ids_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void HandshakeResponse::CopyFrom(const HandshakeResponse& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:rpc.HandshakeResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool HandshakeResponse::IsInitialized() const {
+  return true;
+}
+
+void HandshakeResponse::InternalSwap(HandshakeResponse* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.method_ids_.InternalSwap(&other->_impl_.method_ids_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata HandshakeResponse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_rpc_5fmessage_2eproto_getter, &descriptor_table_rpc_5fmessage_2eproto_once,
+      file_level_metadata_rpc_5fmessage_2eproto[2]);
+}
+
 // @@protoc_insertion_point(namespace_scope)
 }  // namespace rpc
 PROTOBUF_NAMESPACE_OPEN
@@ -521,6 +1001,14 @@ template<> PROTOBUF_NOINLINE ::rpc::RpcMessage*
 Arena::CreateMaybeMessage< ::rpc::RpcMessage >(Arena* arena) {
   return Arena::CreateMessageInternal< ::rpc::RpcMessage >(arena);
 }
+template<> PROTOBUF_NOINLINE ::rpc::HandshakeRequest*
+Arena::CreateMaybeMessage< ::rpc::HandshakeRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::rpc::HandshakeRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::rpc::HandshakeResponse*
+Arena::CreateMaybeMessage< ::rpc::HandshakeResponse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::rpc::HandshakeResponse >(arena);
+}
 PROTOBUF_NAMESPACE_CLOSE
 
 // @@protoc_insertion_point(global_scope)
@@ -1,66 +1,213 @@
 #include "rpc_server.h"
+#include "../common/config.h"
 #include "../common/logger.h"
+#include "method_table.h"
+#include "response_closure.h"
+#include "rpc_codec.h"
 
-RpcServer::RpcServer() {
+RpcServer::RpcServer() : methods_(std::make_unique<MethodTable>()) {
   // Initialize logger singleton
   Logger::GetInstance();
 
-  tcp_server_.SetUpTcpServer([this](std::string& read, std::string& write) {
-    this->HandleRequest(read, write);
-  });
+  tcp_server_ = std::make_unique<TcpServer>();
+
+  int worker_thread_num = Config::GetInstance().server_worker_thread_num();
+  if (worker_thread_num > 0) {
+    worker_pool_ = std::make_unique<WorkStealingPool>(worker_thread_num);
+    worker_pool_->Start();
+    // Finish the methods in flight while their loops can still send.
+    tcp_server_->set_loop_exit_callback([this] { worker_pool_->Stop(); });
+  }
+
+  tcp_server_->SetUpTcpServer(
+      [this](const std::shared_ptr<TcpConnection>& connection,
+             const FrameHeader& header, const IoBuf& request) {
+        this->HandleRequest(connection, header, request);
+      });
 }
 
+RpcServer::~RpcServer() = default;
+
 void RpcServer::StartServer() {
   // LOG_INFO("RpcServer started");
-  tcp_server_.RunLoop();
+  tcp_server_->RunLoop();
+}
+
+void RpcServer::StopServer() {
+  tcp_server_->Quit();
+}
+
+int64_t RpcServer::buffer_bytes() const {
+  return tcp_server_->buffer_bytes();
 }
 
 void RpcServer::ServiceRegister(google::protobuf::Service* service) {
-  service_map_.emplace(service->GetDescriptor()->name(), service);
+  methods_->Register(service);
 }
 
-void RpcServer::HandleRequest(std::string& request, std::string& response) {
+void RpcServer::HandleRequest(const std::shared_ptr<TcpConnection>& connection,
+                              const FrameHeader& header,
+                              const IoBuf& request) {
+  if (UseCompactEnvelope()) {
+    HandleCompactRequest(connection, header, request);
+    return;
+  }
   rpc::RpcMessage request_message;
-  request_message.ParseFromString(request);
+  size_t payload_offset;
+  size_t payload_size;
+  bool parsed =
+      ParseEnvelope(request, rpc::RpcMessage::kRequestFieldNumber,
+                    &request_message, &payload_offset, &payload_size);
 
   // LOG_DEBUG("Received request: \n" + request_message.DebugString());
 
-  if (!CheckRequest(request_message)) {
-    rpc::RpcMessage response_message;
-    response_message.set_id(request_message.id());
-    response_message.set_type(rpc::RPC_TYPE_ERROR);
-    response_message.set_response("Invalid request");
-    response_message.SerializeToString(&response);
+  if (parsed && request_message.type() == rpc::RPC_TYPE_HANDSHAKE) {
+    HandleHandshake(connection, header, request_message.id(), request,
+                    payload_offset, payload_size);
+    return;
+  }
+  uint32_t method_id;
+  if (!parsed || !CheckRequest(request_message, &method_id)) {
+    SendError(connection, header, request_message.id());
     return;
   }
+  Dispatch(connection, header, request_message.id(), method_id, request,
+           payload_offset, payload_size);
+}
+
+void RpcServer::HandleCompactRequest(
+    const std::shared_ptr<TcpConnection>& connection,
+    const FrameHeader& header, const IoBuf& request) {
+  CompactEnvelope envelope;
+  bool decoded = DecodeCompactEnvelope(request, &envelope);
+  if (decoded && envelope.type == rpc::RPC_TYPE_HANDSHAKE) {
+    HandleHandshake(connection, header, envelope.id, request,
+                    kCompactEnvelopeSize,
+                    request.size() - kCompactEnvelopeSize);
+    return;
+  }
+  uint32_t method_id = MethodTable::kInvalidId;
+  if (decoded && envelope.type == rpc::RPC_TYPE_REQUEST) {
+    if (envelope.flags & kEnvelopeMethodId) {
+      // Negotiated: a plain index, no hashing at all.
+      if (envelope.method_key < methods_->size()) {
+        method_id = static_cast<uint32_t>(envelope.method_key);
+      }
+    } else {
+      method_id = methods_->FindByKey(envelope.method_key);
+    }
+  }
+  if (method_id == MethodTable::kInvalidId) {
+    SendError(connection, header, envelope.id);
+    return;
+  }
+  // The rest of the frame is the request itself.
+  Dispatch(connection, header, envelope.id, method_id, request,
+           kCompactEnvelopeSize, request.size() - kCompactEnvelopeSize);
+}
 
-  auto service = service_map_.find(request_message.service_name())->second;
-  auto service_desc = service->GetDescriptor();
-  auto method_desc =
-      service_desc->FindMethodByName(request_message.method_name());
+void RpcServer::Dispatch(const std::shared_ptr<TcpConnection>& connection,
+                         const FrameHeader& header, uint32_t id,
+                         uint32_t method_id, const IoBuf& request,
+                         size_t payload_offset, size_t payload_size) {
+  const MethodTable::Entry* entry = methods_->Get(method_id);
+  auto done = ResponseClosure::Acquire(connection, id, header.request_id,
+                                       *entry->request_prototype,
+                                       *entry->response_prototype);
+  // Straight from the receive buffer, without a copy of the request bytes.
+  if (!ParseMessage(request, payload_offset, payload_size, done->request())) {
+    done->Release();
+    SendError(connection, header, id);
+    return;
+  }
+  CallService(entry->service, entry->method, done);
+}
 
-  auto method_request = service->GetRequestPrototype(method_desc).New();
-  auto method_response = service->GetResponsePrototype(method_desc).New();
-  method_request->ParseFromString(request_message.request());
+void RpcServer::CallService(google::protobuf::Service* service,
+                            const google::protobuf::MethodDescriptor* method,
+                            ResponseClosure* done) {
+  // The method may return before running done, e.g. when it suspends in a
+  // coroutine, and the loop goes on serving other connections meanwhile.
+  if (worker_pool_ == nullptr) {
+    service->CallMethod(method, nullptr, done->request(), done->response(),
+                        done);
+    return;
+  }
+  // A slow method then only holds up its worker; done still sends the
+  // response from the connection's loop.
+  worker_pool_->Submit([service, method, done] {
+    service->CallMethod(method, nullptr, done->request(), done->response(),
+                        done);
+  });
+}
 
-  service->CallMethod(method_desc, nullptr, method_request, method_response,
-                      nullptr);
+void RpcServer::HandleHandshake(
+    const std::shared_ptr<TcpConnection>& connection,
+    const FrameHeader& header, uint32_t id, const IoBuf& request,
+    size_t payload_offset, size_t payload_size) {
+  rpc::HandshakeRequest handshake;
+  if (!ParseMessage(request, payload_offset, payload_size, &handshake)) {
+    SendError(connection, header, id);
+    return;
+  }
+  // The table's IDs hold for every connection, so nothing is kept per
+  // connection; the client just learns them.
+  rpc::HandshakeResponse response;
+  for (const std::string& name : handshake.method_names()) {
+    response.add_method_ids(methods_->FindByFullName(name));
+  }
+  SendReply(connection, header, id, rpc::RPC_TYPE_HANDSHAKE,
+            response.SerializeAsString());
+}
 
-  rpc::RpcMessage response_message;
-  response_message.set_id(request_message.id());
-  response_message.set_type(rpc::RPC_TYPE_RESPONSE);
-  response_message.set_response(method_response->SerializeAsString());
-  response_message.SerializeToString(&response);
+void RpcServer::SendError(const std::shared_ptr<TcpConnection>& connection,
+                          const FrameHeader& header, uint32_t id) {
+  SendReply(connection, header, id, rpc::RPC_TYPE_ERROR, "Invalid request");
+}
 
-  // LOG_DEBUG("Send response: \n" + response_message.DebugString());
+void RpcServer::SendReply(const std::shared_ptr<TcpConnection>& connection,
+                          const FrameHeader& header, uint32_t id,
+                          int type, const std::string& payload) {
+  bool failed = type == rpc::RPC_TYPE_ERROR;
+  // The v2 id survives an envelope that didn't parse.
+  FrameHeader response_header;
+  response_header.request_id = header.request_id;
+  response_header.flags =
+      Codec::kFlagResponse | (failed ? Codec::kFlagError : 0);
+  std::string response;
+  if (UseCompactEnvelope()) {
+    CompactEnvelope envelope;
+    envelope.type = static_cast<uint8_t>(type);
+    envelope.status = failed ? kStatusInvalidRequest : kStatusOk;
+    envelope.id = id;
+    response.resize(kCompactEnvelopeSize);
+    EncodeCompactEnvelope(envelope, response.data());
+    response += payload;
+  } else {
+    rpc::RpcMessage response_message;
+    response_message.set_id(id);
+    response_message.set_type(static_cast<rpc::MessageType>(type));
+    response_message.set_response(payload);
+    response = response_message.SerializeAsString();
+  }
+  connection->Send(response, response_header);
 }
 
-bool RpcServer::CheckRequest(rpc::RpcMessage request) {
+bool RpcServer::CheckRequest(const rpc::RpcMessage& request,
+                             uint32_t* method_id) {
   if (request.type() != rpc::RPC_TYPE_REQUEST) {
     // LOG_ERROR("Invalid request type: " + std::to_string(request.type()));
     return false;
   }
 
+  if (request.has_method_id()) {
+    // Negotiated by the handshake: a plain index.
+    *method_id = methods_->Get(request.method_id()) != nullptr
+                     ? request.method_id()
+                     : MethodTable::kInvalidId;
+    return *method_id != MethodTable::kInvalidId;
+  }
+
   if (request.method_name().empty()) {
     // LOG_ERROR("Empty method name");
     return false;
@@ -71,25 +218,13 @@ bool RpcServer::CheckRequest(rpc::RpcMessage request) {
     return false;
   }
 
-  if (service_map_.find(request.service_name()) == service_map_.end()) {
-    // LOG_ERROR("Service not found: " + request.service_name());
-    return false;
-  }
-  auto service = service_map_.find(request.service_name())->second;
-  // if (service == nullptr) {
-  //   LOG_ERROR("Service not found: " + request.service_name());
-  //   return false;
-  // }
-
-  auto service_desc = service->GetDescriptor();
-  auto method_desc = service_desc->FindMethodByName(request.method_name());
-  if (method_desc == nullptr) {
-    // LOG_ERROR("Method not found: " + request.method_name());
-    return false;
-  }
-
-  if (request.request().empty()) {
-    // LOG_ERROR("Empty request");
+  // One hash and one name comparison instead of the service and method
+  // lookups by name.
+  *method_id =
+      methods_->FindByName(request.service_name(), request.method_name());
+  if (*method_id == MethodTable::kInvalidId) {
+    // LOG_ERROR("Method not found: " + request.service_name() + "." +
+    //           request.method_name());
     return false;
   }
 
@@ -3,27 +3,84 @@
 
 #include <google/protobuf/service.h>
 
+#include <memory>
 #include <string>
 #include "photonrpc/rpc_message.pb.h"
+#include "../common/work_stealing_pool.h"
 #include "../net/tcp_server.h"
 
-// TODO: implement a tcp_client to maintain the tcp connection for better performance
+class MethodTable;
+class ResponseClosure;
+
+// NOTE: keep the data members in sync with include/photonrpc/rpc.h.
 class RpcServer {
  public:
   RpcServer();
 
+  ~RpcServer();
+
+  // Accepts connections until StopServer() or SIGINT/SIGTERM. Register the
+  // services before, nothing is dispatched to them earlier.
   void StartServer();
 
+  // Makes StartServer() return. May be called from any thread.
+  void StopServer();
+
   void ServiceRegister(google::protobuf::Service*);
 
+  // Bytes held by the buffers of all connections, see the buffer section
+  // of the config for how they are reclaimed. Any thread, until
+  // StartServer() returns.
+  int64_t buffer_bytes() const;
+
  private:
-  TcpServer tcp_server_;
+  std::unique_ptr<TcpServer> tcp_server_;
+  // Runs the service methods when worker_thread_num > 0. Declared after
+  // tcp_server_ so that it is stopped while the I/O loops still exist.
+  std::unique_ptr<WorkStealingPool> worker_pool_;
+
+  // Dispatches one request. The response is sent when the method runs its
+  // done closure, which may happen later and in another thread.
+  void HandleRequest(const std::shared_ptr<TcpConnection>& connection,
+                     const FrameHeader& header, const IoBuf& request);
+
+  void HandleCompactRequest(const std::shared_ptr<TcpConnection>& connection,
+                            const FrameHeader& header, const IoBuf& request);
+
+  // Parses the payload of a checked request and calls method `method_id`,
+  // answering with `id` in the envelope.
+  void Dispatch(const std::shared_ptr<TcpConnection>& connection,
+                const FrameHeader& header, uint32_t id, uint32_t method_id,
+                const IoBuf& request, size_t payload_offset,
+                size_t payload_size);
+
+  // Runs the method in this thread, or in the worker pool if there is one.
+  void CallService(google::protobuf::Service* service,
+                   const google::protobuf::MethodDescriptor* method,
+                   ResponseClosure* done);
+
+  // Answers an RPC_TYPE_HANDSHAKE request with the IDs of the methods it
+  // names.
+  void HandleHandshake(const std::shared_ptr<TcpConnection>& connection,
+                       const FrameHeader& header, uint32_t id,
+                       const IoBuf& request, size_t payload_offset,
+                       size_t payload_size);
+
+  // Replies "Invalid request".
+  void SendError(const std::shared_ptr<TcpConnection>& connection,
+                 const FrameHeader& header, uint32_t id);
 
-  void HandleRequest(std::string& request, std::string& response);
+  // Sends `payload` as a reply of `type` in the configured envelope.
+  void SendReply(const std::shared_ptr<TcpConnection>& connection,
+                 const FrameHeader& header, uint32_t id, int type,
+                 const std::string& payload);
 
-  bool CheckRequest(rpc::RpcMessage request);
+  // Stores the ID of the requested method, by name or negotiated, in
+  // `*method_id`. An empty payload is a request with only default fields.
+  bool CheckRequest(const rpc::RpcMessage& request, uint32_t* method_id);
 
-  std::map<std::string, google::protobuf::Service*> service_map_;
+  // Built by ServiceRegister(); requests are dispatched by its method IDs.
+  std::unique_ptr<MethodTable> methods_;
 };
 
-#endif  //PHOTONRPC_RPC_SERVER_H
\ No newline at end of file
+#endif  //PHOTONRPC_RPC_SERVER_H
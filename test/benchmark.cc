@@ -3,11 +3,15 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstring>
+#include <future>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #define NUM_OF_THREADS 8
 #define NUM_OF_REQUESTS_PER_THREAD 1000
+#define NUM_OF_ASYNC_REQUESTS 8000
 
 std::atomic<int> request_count(0);
 
@@ -28,16 +32,46 @@ void thread_func() {
   }
 }
 
-int main() {
-  auto start_time = std::chrono::high_resolution_clock::now();
+void async_done(std::promise<void>* all_done) {
+  if (++request_count == NUM_OF_ASYNC_REQUESTS) {
+    all_done->set_value();
+  }
+}
 
-  std::thread threads[NUM_OF_THREADS];
-  for (int i = 0; i < NUM_OF_THREADS; ++i) {
-    threads[i] = std::thread(thread_func);
+// One thread keeps every request in flight at once through closures.
+void async_func() {
+  RpcChannel channel;
+  rpc::CalculateService_Stub calculate_service_stub(&channel);
+
+  rpc::AddRequest add_request;
+  add_request.set_a(5);
+  add_request.set_b(6);
+  std::vector<rpc::AddResponse> add_responses(NUM_OF_ASYNC_REQUESTS);
+
+  std::promise<void> all_done;
+  for (int i = 0; i < NUM_OF_ASYNC_REQUESTS; i++) {
+    calculate_service_stub.Add(
+        nullptr, &add_request, &add_responses[i],
+        google::protobuf::NewCallback(&async_done, &all_done));
   }
+  all_done.get_future().wait();
+}
+
+int main(int argc, char* argv[]) {
+  bool async_mode = argc > 1 && strcmp(argv[1], "async") == 0;
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  if (async_mode) {
+    async_func();
+  } else {
+    std::thread threads[NUM_OF_THREADS];
+    for (int i = 0; i < NUM_OF_THREADS; ++i) {
+      threads[i] = std::thread(thread_func);
+    }
 
-  for (int i = 0; i < NUM_OF_THREADS; ++i) {
-    threads[i].join();
+    for (int i = 0; i < NUM_OF_THREADS; ++i) {
+      threads[i].join();
+    }
   }
 
   auto end_time = std::chrono::high_resolution_clock::now();
@@ -51,4 +85,4 @@ int main() {
   std::cout << "QPS: " << qps << std::endl;
 
   return 0;
-}
\ No newline at end of file
+}
@@ -1,9 +1,33 @@
+#include "../include/photonrpc/coroutine.h"
 #include "../include/photonrpc/rpc.h"
 #include "calculate_service.pb.h"
 #include "echo_service.pb.h"
 
 #include <iostream>
 
+class CalculateCoStub : public AwaitableStub<rpc::CalculateService_Stub> {
+ public:
+  using AwaitableStub::AwaitableStub;
+
+  PHOTONRPC_AWAITABLE_METHOD(Add)
+  PHOTONRPC_AWAITABLE_METHOD(Sub)
+};
+
+Task<int> AddThenSub(RpcChannel* channel, int arg1, int arg2) {
+  CalculateCoStub calculate_stub(channel);
+
+  rpc::AddRequest add_request;
+  add_request.set_a(arg1);
+  add_request.set_b(arg2);
+  rpc::AddResponse add_response = co_await calculate_stub.Add(add_request);
+
+  rpc::SubRequest sub_request;
+  sub_request.set_a(add_response.result());
+  sub_request.set_b(arg2);
+  rpc::SubResponse sub_response = co_await calculate_stub.Sub(sub_request);
+  co_return sub_response.result();
+}
+
 int main() {
   RpcChannel channel;
 
@@ -35,5 +59,8 @@ int main() {
   calculate_service_stub.Sub(nullptr, &sub_request, &sub_response, nullptr);
   std::cout << "Received from server: " << sub_response.result() << std::endl;
 
+  int result = SyncWait(AddThenSub(&channel, arg1, arg2));
+  std::cout << "Received from coroutine: " << result << std::endl;
+
   return 0;
-}
\ No newline at end of file
+}
@@ -1,20 +1,40 @@
+#include "../include/photonrpc/coroutine.h"
 #include "../include/photonrpc/rpc.h"
 #include "calculate_service.pb.h"
 #include "echo_service.pb.h"
 
 class CalculateServiceImpl : public rpc::CalculateService {
  public:
+  explicit CalculateServiceImpl(google::protobuf::RpcChannel* downstream)
+      : downstream_(downstream) {}
+
   void Add(google::protobuf::RpcController* controller,
            const rpc::AddRequest* request, rpc::AddResponse* response,
            google::protobuf::Closure* done) override {
     response->set_result(request->a() + request->b());
+    done->Run();
   }
 
+  // Suspends on a downstream call, the loop keeps serving in the meantime.
   void Sub(google::protobuf::RpcController* controller,
            const rpc::SubRequest* request, rpc::SubResponse* response,
            google::protobuf::Closure* done) override {
-    response->set_result(request->a() - request->b());
+    CoSpawn(SubThroughAdd(request, response), done);
+  }
+
+ private:
+  Task<void> SubThroughAdd(const rpc::SubRequest* request,
+                           rpc::SubResponse* response) {
+    AwaitableStub<rpc::CalculateService_Stub> stub(downstream_);
+    rpc::AddRequest add_request;
+    add_request.set_a(request->a());
+    add_request.set_b(-request->b());
+    rpc::AddResponse add_response =
+        co_await stub.Call(&rpc::CalculateService_Stub::Add, add_request);
+    response->set_result(add_response.result());
   }
+
+  google::protobuf::RpcChannel* downstream_;
 };
 
 class EchoServiceImpl : public rpc::EchoService {
@@ -23,16 +43,19 @@ class EchoServiceImpl : public rpc::EchoService {
             const rpc::EchoRequest* request, rpc::EchoResponse* response,
             google::protobuf::Closure* done) override {
     response->set_result(request->sentence());
+    done->Run();
   }
 };
 
 int main() {
   RpcServer rpc_server;
+  // Loops back to this server, standing in for another service.
+  RpcChannel downstream;
 
   rpc_server.ServiceRegister(new EchoServiceImpl());
-  rpc_server.ServiceRegister(new CalculateServiceImpl());
+  rpc_server.ServiceRegister(new CalculateServiceImpl(&downstream));
 
   rpc_server.StartServer();
 
   return 0;
-}
\ No newline at end of file
+}
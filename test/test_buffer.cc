@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "../src/core/net/buffer.h"
+#include "../src/core/net/buffer_pool.h"
 #include "../src/core/net/codec.h"
 
 #include <errno.h>
@@ -8,6 +9,9 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <memory>
+#include <vector>
+
 // 1. 基础功能：读写一致性
 TEST(BufferTest, BasicReadWrite) {
   Buffer buf(1024);
@@ -601,4 +605,387 @@ TEST(BufferSendFdTest, SendMultipleChunks) {
 
   close(fds[0]);
   close(fds[1]);
-}
\ No newline at end of file
+}
+// ----------------------------------------------------------------------------
+// PeekSpans 测试：不拷贝地查看可读数据
+// ----------------------------------------------------------------------------
+
+// 24. 未回绕时只有一段
+TEST(BufferSpansTest, ContiguousData) {
+  Buffer buf(64);
+  std::string data = "contiguous";
+  buf.WriteData(data, data.size());
+
+  BufferSpans spans = buf.PeekSpans();
+  EXPECT_TRUE(spans.contiguous());
+  EXPECT_EQ(spans.first, data);
+  EXPECT_EQ(spans.size(), data.size());
+}
+
+// 25. 回绕时分为两段，拼起来与 PeekData 一致
+TEST(BufferSpansTest, WrappedData) {
+  Buffer buf(10);
+  std::string s1 = "123456";
+  buf.WriteData(s1, 6);
+  buf.RetrieveData(4);
+  std::string s2 = "789ab";
+  buf.WriteData(s2, 5);  // read_index=4, 7 bytes, wraps at 10
+
+  BufferSpans spans = buf.PeekSpans();
+  EXPECT_FALSE(spans.contiguous());
+  EXPECT_EQ(spans.first, "56789a");
+  EXPECT_EQ(spans.second, "b");
+  EXPECT_EQ(spans.ToString(), buf.PeekData());
+}
+
+// 26. Sub/CopyTo 跨越两段
+TEST(BufferSpansTest, SubRangeAcrossWrap) {
+  Buffer buf(10);
+  std::string s1 = "xxxxxxxx";
+  buf.WriteData(s1, 8);
+  buf.RetrieveData(8);
+  std::string s2 = "abcdef";
+  buf.WriteData(s2, 6);  // "ab" | "cdef"
+
+  BufferSpans spans = buf.PeekSpans();
+  EXPECT_EQ(spans.first, "ab");
+  BufferSpans middle = spans.Sub(1, 3);
+  EXPECT_EQ(middle.first, "b");
+  EXPECT_EQ(middle.second, "cd");
+  EXPECT_TRUE(spans.Sub(3, 2).contiguous());
+  EXPECT_EQ(spans.Sub(3, 2).first, "de");
+
+  char copied[4];
+  spans.CopyTo(1, 4, copied);
+  EXPECT_EQ(std::string(copied, 4), "bcde");
+}
+
+TEST(BufferSpansTest, EmptyBuffer) {
+  Buffer buf;
+  BufferSpans spans = buf.PeekSpans();
+  EXPECT_EQ(spans.size(), 0);
+  EXPECT_TRUE(spans.contiguous());
+}
+
+// ----------------------------------------------------------------------------
+// 分散/聚集 I/O：readv 写入环形空闲区和栈上溢出区，sendmsg 一次发送两段
+// ----------------------------------------------------------------------------
+
+// 27. 一次 ReceiveFd 读完超出环形空闲空间的数据
+TEST(BufferScatterGatherTest, ReceiveOverflowsIntoExtraArea) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  int sndbuf = 256 * 1024;
+  setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+  fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK);
+
+  Buffer buf(64);
+  std::string data;
+  for (int i = 0; i < 30000; i++) {
+    data.push_back(static_cast<char>('a' + i % 26));
+  }
+  ASSERT_EQ(send(fds[1], data.data(), data.size(), 0),
+            static_cast<ssize_t>(data.size()));
+
+  EXPECT_TRUE(buf.ReceiveFd(fds[0]));
+  EXPECT_EQ(buf.PeekData(), data);
+
+  // 已经读空：非阻塞 socket 返回 EAGAIN
+  int saved_errno = 0;
+  EXPECT_FALSE(buf.ReceiveFd(fds[0], &saved_errno));
+  EXPECT_EQ(saved_errno, EAGAIN);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// 28. 读入的数据在环形缓冲区中回绕
+TEST(BufferScatterGatherTest, ReceiveIntoWrappedFreeSpace) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  Buffer buf(16);
+  std::string s1 = "0123456789ab";
+  buf.WriteData(s1, s1.size());
+  buf.RetrieveData(10);  // "ab" at index 10..11, free space wraps
+
+  std::string data = "cdefghijkl";
+  send(fds[1], data.data(), data.size(), 0);
+  EXPECT_TRUE(buf.ReceiveFd(fds[0]));
+  EXPECT_EQ(buf.PeekData(), "ab" + data);
+  EXPECT_FALSE(buf.PeekSpans().contiguous());
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// 29. 回绕的数据用一次 sendmsg 发出
+TEST(BufferScatterGatherTest, SendWrappedDataInOneCall) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  Buffer buf(16);
+  std::string s1 = "xxxxxxxxxxxx";
+  buf.WriteData(s1, s1.size());
+  buf.RetrieveData(12);
+  std::string data = "wrapped-data";
+  buf.WriteData(data, data.size());
+  ASSERT_FALSE(buf.PeekSpans().contiguous());
+
+  EXPECT_TRUE(buf.SendFd(fds[0]));
+  EXPECT_EQ(buf.GetSize(), 0);
+
+  char recv_buffer[64];
+  ssize_t received = recv(fds[1], recv_buffer, sizeof(recv_buffer), 0);
+  EXPECT_EQ(std::string(recv_buffer, received), data);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// 30. 写满整个容量后再扩容，回绕部分保持顺序
+TEST(BufferTest, GrowFromFullWrappedRing) {
+  Buffer buf(8);
+  std::string s1 = "abcdef";
+  buf.WriteData(s1, 6);
+  buf.RetrieveData(4);
+  std::string s2 = "ghijkl";
+  buf.WriteData(s2, 6);  // exactly full, wraps
+  EXPECT_EQ(buf.GetWritableSize(), 0);
+
+  std::string s3 = "mno";
+  buf.WriteData(s3, 3);
+  EXPECT_EQ(buf.PeekData(), "efghijklmno");
+}
+
+// ----------------------------------------------------------------------------
+// 镜像映射后端：同一组页面映射两次，可读数据总是连续的
+// ----------------------------------------------------------------------------
+
+// 31. 回绕的数据仍是一段连续内存
+TEST(MirroredBufferTest, WrappedDataIsContiguous) {
+  Buffer buf(4096, Buffer::Backend::kMirrored);
+  ASSERT_EQ(buf.backend(), Buffer::Backend::kMirrored);
+  int capacity = buf.GetCapacity();
+  EXPECT_EQ(capacity % 4096, 0);
+
+  std::string s1(capacity - 10, 'a');
+  buf.WriteData(s1, s1.size());
+  buf.RetrieveData(s1.size());
+  std::string s2 = "0123456789wrapped";
+  buf.WriteData(s2, s2.size());  // wraps at the end of the mapping
+
+  BufferSpans spans = buf.PeekSpans();
+  EXPECT_TRUE(spans.contiguous());
+  EXPECT_EQ(spans.first, s2);
+  EXPECT_EQ(buf.PeekData(), s2);
+}
+
+// 32. 扩容后数据保持顺序
+TEST(MirroredBufferTest, GrowKeepsOrder) {
+  Buffer buf(4096, Buffer::Backend::kMirrored);
+  int capacity = buf.GetCapacity();
+  std::string s1(capacity - 100, 'x');
+  buf.WriteData(s1, s1.size());
+  buf.RetrieveData(s1.size() - 50);
+  std::string s2(capacity, 'y');
+  buf.WriteData(s2, s2.size());
+
+  EXPECT_GT(buf.GetCapacity(), capacity);
+  EXPECT_TRUE(buf.PeekSpans().contiguous());
+  EXPECT_EQ(buf.PeekData(), std::string(50, 'x') + s2);
+}
+
+// 33. 通过 socket 收发
+TEST(MirroredBufferTest, ReceiveAndSend) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  Buffer buf(4096, Buffer::Backend::kMirrored);
+  std::string pad(buf.GetCapacity() - 5, 'p');
+  buf.WriteData(pad, pad.size());
+  buf.RetrieveData(pad.size());
+
+  std::string data = "mirrored ring data";
+  send(fds[1], data.data(), data.size(), 0);
+  EXPECT_TRUE(buf.ReceiveFd(fds[0]));
+  EXPECT_TRUE(buf.PeekSpans().contiguous());
+  EXPECT_EQ(buf.PeekData(), data);
+
+  EXPECT_TRUE(buf.SendFd(fds[0]));
+  char recv_buffer[64];
+  ssize_t received = recv(fds[1], recv_buffer, sizeof(recv_buffer), 0);
+  EXPECT_EQ(std::string(recv_buffer, received), data);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// ----------------------------------------------------------------------------
+// 线程本地缓存池：存储块在Buffer析构后被下一个Buffer复用
+// ----------------------------------------------------------------------------
+
+const char* StorageOf(Buffer& buf) {
+  std::string byte = "x";
+  buf.WriteData(byte, 1);
+  const char* data = buf.PeekSpans().first.data();
+  buf.RetrieveData(1);
+  return data;
+}
+
+// 34. 容量按2的幂取整，小于最小等级的保持原样
+TEST(BufferPoolTest, RoundsToSizeClasses) {
+  EXPECT_EQ(Buffer(1024).GetCapacity(), 1024);
+  EXPECT_EQ(Buffer(1500).GetCapacity(), 2048);
+  EXPECT_EQ(Buffer(10).GetCapacity(), 10);
+}
+
+// 35. 析构后的块被同一线程的下一个Buffer复用
+TEST(BufferPoolTest, ReusesReleasedStorage) {
+  const char* released;
+  {
+    Buffer buf(4096);
+    released = StorageOf(buf);
+  }
+  size_t pooled = BufferPool::PooledBytes(Buffer::Backend::kHeap);
+  EXPECT_GE(pooled, 4096u);
+
+  Buffer reused(3000);
+  EXPECT_EQ(StorageOf(reused), released);
+  EXPECT_EQ(BufferPool::PooledBytes(Buffer::Backend::kHeap), pooled - 4096);
+}
+
+// 36. 扩容释放的旧块进入池中，供其他Buffer使用
+TEST(BufferPoolTest, GrowthReturnsOldBlock) {
+  Buffer growing(1024);
+  const char* old_storage = StorageOf(growing);
+  std::string data(1500, 'g');
+  growing.WriteData(data, data.size());
+  EXPECT_EQ(growing.GetCapacity(), 2048);
+  EXPECT_EQ(growing.PeekData(), data);
+
+  Buffer next(1024);
+  EXPECT_EQ(StorageOf(next), old_storage);
+}
+
+// 37. 池的大小有上限
+TEST(BufferPoolTest, PoolIsBounded) {
+  {
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    for (int i = 0; i < 8; i++) {
+      buffers.push_back(
+          std::make_unique<Buffer>(BufferPool::kMaxPooledSize));
+    }
+  }
+  EXPECT_LE(BufferPool::PooledBytes(Buffer::Backend::kHeap),
+            BufferPool::kMaxPooledBytes);
+}
+
+// 38. 镜像映射同样被复用
+TEST(BufferPoolTest, ReusesMirroredMappings) {
+  const char* released;
+  {
+    Buffer buf(8192, Buffer::Backend::kMirrored);
+    ASSERT_EQ(buf.backend(), Buffer::Backend::kMirrored);
+    released = StorageOf(buf);
+  }
+  Buffer reused(8192, Buffer::Backend::kMirrored);
+  EXPECT_EQ(StorageOf(reused), released);
+  EXPECT_EQ(reused.backend(), Buffer::Backend::kMirrored);
+}
+
+// ----------------------------------------------------------------------------
+// 收缩：长时间空闲或利用率低的缓冲区归还存储
+// ----------------------------------------------------------------------------
+
+// 39. 收缩保留数据，回绕的数据移到开头
+TEST(BufferShrinkTest, ShrinkKeepsData) {
+  Buffer buf(1024);
+  std::string big(60000, 'b');
+  buf.WriteData(big, big.size());
+  EXPECT_EQ(buf.GetCapacity(), 65536);
+  EXPECT_EQ(buf.peak_size(), 60000);
+  buf.RetrieveData(59990);
+
+  buf.Shrink(1024);
+  EXPECT_EQ(buf.GetCapacity(), 1024);
+  EXPECT_EQ(buf.PeekData(), std::string(10, 'b'));
+  EXPECT_EQ(buf.peak_size(), 10);
+
+  std::string more = "more";
+  buf.WriteData(more, more.size());
+  EXPECT_EQ(buf.PeekData(), std::string(10, 'b') + more);
+}
+
+// 40. 数据放不下或容量不会变小时不收缩
+TEST(BufferShrinkTest, NeverDropsDataOrGrows) {
+  Buffer buf(4096);
+  std::string data(3000, 'd');
+  buf.WriteData(data, data.size());
+  buf.Shrink(1024);
+  EXPECT_EQ(buf.GetCapacity(), 4096);
+  EXPECT_EQ(buf.PeekData(), data);
+
+  buf.Shrink(100000);
+  EXPECT_EQ(buf.GetCapacity(), 4096);
+}
+
+// 41. 全局计数反映存活和缓存的存储
+TEST(BufferShrinkTest, GlobalCounters) {
+  int64_t allocated = BufferPool::TotalAllocatedBytes();
+  int64_t pooled = BufferPool::TotalPooledBytes();
+  {
+    Buffer buf(1 << 20);
+    EXPECT_EQ(BufferPool::TotalAllocatedBytes(), allocated + (1 << 20));
+    buf.Shrink(1024);
+    EXPECT_EQ(BufferPool::TotalAllocatedBytes(), allocated + 1024);
+  }
+  EXPECT_EQ(BufferPool::TotalAllocatedBytes(), allocated);
+  EXPECT_GE(BufferPool::TotalPooledBytes(), pooled);
+}
+
+// ----------------------------------------------------------------------------
+// 原地写入：先写消息体，再回填前面预留的长度头
+// ----------------------------------------------------------------------------
+
+// 42. 预留头部后原地写入并回填
+TEST(BufferAppendTest, BackfillsReservedHeader) {
+  Buffer buf(64);
+  char* frame = buf.BeginAppend(Codec::kHeaderSize + 5);
+  memcpy(frame + Codec::kHeaderSize, "hello", 5);
+  Codec::EncodeHeader(5, frame);
+  buf.EndAppend(Codec::kHeaderSize + 5);
+
+  BufferSpans payload;
+  int frame_size;
+  ASSERT_TRUE(Codec::DecodeFrame(buf.PeekSpans(), &payload, &frame_size));
+  EXPECT_EQ(payload.ToString(), "hello");
+  EXPECT_EQ(frame_size, Codec::kHeaderSize + 5);
+}
+
+// 43. 空闲空间回绕时先整理数据，保证返回的空间连续
+TEST(BufferAppendTest, WrappedFreeSpaceIsMadeContiguous) {
+  Buffer buf(16);
+  std::string s1 = "0123456789AB";
+  buf.WriteData(s1, s1.size());
+  buf.RetrieveData(10);  // "AB" at the end, 14 free bytes wrapping around
+
+  char* space = buf.BeginAppend(8);
+  memcpy(space, "contig!!", 8);
+  buf.EndAppend(8);
+  EXPECT_EQ(buf.GetCapacity(), 16);
+  EXPECT_TRUE(buf.PeekSpans().contiguous());
+  EXPECT_EQ(buf.PeekData(), "ABcontig!!");
+}
+
+// 44. 只提交实际写入的部分
+TEST(BufferAppendTest, CommitsOnlyWhatWasWritten) {
+  Buffer buf(16);
+  char* space = buf.BeginAppend(10);
+  memcpy(space, "abc", 3);
+  buf.EndAppend(3);
+  EXPECT_EQ(buf.PeekData(), "abc");
+  std::string more = "def";
+  buf.WriteData(more, more.size());
+  EXPECT_EQ(buf.PeekData(), "abcdef");
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include "../src/core/net/codec.h"
+#include "../src/core/net/frame_decoder.h"
 
 // 辅助函数：手动构造一个带 4 字节头部的原始字节流
 std::string ManualEncode(const std::string& payload) {
@@ -213,3 +214,290 @@ TEST(CodecTest, ComplexStickyAndPartial) {
   std::string r3 = Codec::decode(stream, stream.size());
   EXPECT_TRUE(r3.empty());
 }
+
+// ----------------------------------------------------------------------------
+// 10. DecodeFrame：直接在 Buffer 的视图上解码，不拷贝负载
+// ----------------------------------------------------------------------------
+TEST(CodecTest, DecodeFrameOnSpans) {
+  std::string msg1 = "first";
+  std::string msg2 = "second frame";
+  std::string stream = Codec::encode(msg1) + Codec::encode(msg2);
+
+  BufferSpans data;
+  data.first = stream;
+  BufferSpans payload;
+  int frame_size = 0;
+  ASSERT_TRUE(Codec::DecodeFrame(data, &payload, &frame_size));
+  EXPECT_EQ(payload.ToString(), msg1);
+  EXPECT_EQ(frame_size, 4 + static_cast<int>(msg1.size()));
+  // 负载视图指向原数据，没有拷贝
+  EXPECT_EQ(payload.first.data(), stream.data() + 4);
+
+  BufferSpans rest = data.Sub(frame_size, data.size() - frame_size);
+  ASSERT_TRUE(Codec::DecodeFrame(rest, &payload, &frame_size));
+  EXPECT_EQ(payload.ToString(), msg2);
+
+  BufferSpans partial = data.Sub(0, 6);
+  EXPECT_FALSE(Codec::DecodeFrame(partial, &payload, &frame_size));
+}
+
+// 头部和负载都跨越环形缓冲区末尾
+TEST(CodecTest, DecodeFrameHeaderAcrossWrap) {
+  std::string msg = "wrapped payload";
+  std::string encoded = Codec::encode(msg);
+
+  BufferSpans data;
+  data.first = std::string_view(encoded).substr(0, 2);
+  data.second = std::string_view(encoded).substr(2);
+  BufferSpans payload;
+  int frame_size = 0;
+  ASSERT_TRUE(Codec::DecodeFrame(data, &payload, &frame_size));
+  EXPECT_EQ(payload.ToString(), msg);
+  EXPECT_EQ(frame_size, static_cast<int>(encoded.size()));
+}
+
+// ----------------------------------------------------------------------------
+// 11. FrameDecoder：跨多次读取保留状态，一次取出所有完整帧
+// ----------------------------------------------------------------------------
+TEST(FrameDecoderTest, AllCompleteFramesInOnePass) {
+  std::string msg1 = "first";
+  std::string msg2 = "";
+  std::string msg3 = "third frame";
+  std::string stream =
+      Codec::encode(msg1) + Codec::encode(msg2) + Codec::encode(msg3);
+  BufferSpans data;
+  data.first = stream;
+
+  FrameDecoder decoder;
+  std::vector<FrameView> frames;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(data.Sub(frames[0].offset, frames[0].size).ToString(), msg1);
+  EXPECT_EQ(frames[1].size, 0u);
+  EXPECT_EQ(data.Sub(frames[2].offset, frames[2].size).ToString(), msg3);
+  EXPECT_EQ(decoder.state(), FrameDecoder::State::kHeader);
+  EXPECT_EQ(decoder.TakeDecoded(), stream.size());
+}
+
+// 逐字节到达：帧头只解析一次，帧体收齐时才交出
+TEST(FrameDecoderTest, KeepsStateAcrossReads) {
+  std::string msg1 = "byte by byte";
+  std::string msg2 = "next";
+  std::string stream = Codec::encode(msg1) + Codec::encode(msg2);
+
+  FrameDecoder decoder;
+  std::vector<std::string> decoded;
+  // The unconsumed input, as a connection's buffer would hold it.
+  std::string input;
+  for (char c : stream) {
+    input.push_back(c);
+    BufferSpans data;
+    data.first = input;
+    std::vector<FrameView> frames;
+    ASSERT_TRUE(decoder.Decode(data, &frames));
+    for (const FrameView& view : frames) {
+      decoded.push_back(data.Sub(view.offset, view.size).ToString());
+    }
+    input.erase(0, decoder.TakeDecoded());
+    if (input.size() >= 4 && decoded.size() < 2) {
+      EXPECT_EQ(decoder.state(), FrameDecoder::State::kBody);
+    }
+  }
+  ASSERT_EQ(decoded.size(), 2u);
+  EXPECT_EQ(decoded[0], msg1);
+  EXPECT_EQ(decoded[1], msg2);
+  EXPECT_TRUE(input.empty());
+}
+
+TEST(FrameDecoderTest, PartialFrameAndMissingBytes) {
+  std::string msg1 = "done";
+  std::string msg2(100, 'x');
+  std::string stream = Codec::encode(msg1) + Codec::encode(msg2);
+  BufferSpans data;
+  data.first = std::string_view(stream).substr(0, 8 + 4 + 30);
+
+  FrameDecoder decoder;
+  std::vector<FrameView> frames;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(decoder.state(), FrameDecoder::State::kBody);
+  EXPECT_EQ(decoder.body_size(), msg2.size());
+  EXPECT_EQ(decoder.Missing(data), 70u);
+  // The partial frame now starts the input.
+  EXPECT_EQ(decoder.TakeDecoded(), 8u);
+
+  decoder.Reset();
+  EXPECT_EQ(decoder.state(), FrameDecoder::State::kHeader);
+}
+
+TEST(FrameDecoderTest, HeaderAcrossWrapAndNegativeLength) {
+  std::string msg = "wrapped";
+  std::string encoded = Codec::encode(msg);
+  BufferSpans data;
+  data.first = std::string_view(encoded).substr(0, 3);
+  data.second = std::string_view(encoded).substr(3);
+  FrameDecoder decoder;
+  std::vector<FrameView> frames;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(data.Sub(frames[0].offset, frames[0].size).ToString(), msg);
+
+  int bad_length = -5;
+  std::string bad(reinterpret_cast<const char*>(&bad_length), 4);
+  BufferSpans bad_data;
+  bad_data.first = bad;
+  FrameDecoder bad_decoder;
+  EXPECT_FALSE(bad_decoder.Decode(bad_data, &frames));
+}
+
+// 帧体上限：仅凭帧头拒绝超过上限的帧，不等帧体到达
+TEST(FrameDecoderTest, RejectsBodyAboveMaximum) {
+  std::string fits(64, 'x');
+  std::string stream = Codec::encode(fits);
+  BufferSpans data;
+  data.first = stream;
+  FrameDecoder decoder(1, 64);
+  std::vector<FrameView> frames;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  ASSERT_EQ(frames.size(), 1u);
+
+  int too_long = 65;
+  std::string header(reinterpret_cast<const char*>(&too_long), 4);
+  BufferSpans header_only;
+  header_only.first = header;
+  FrameDecoder limited(1, 64);
+  EXPECT_FALSE(limited.Decode(header_only, &frames));
+
+  // 0表示不限制
+  FrameDecoder unlimited(1, 0);
+  EXPECT_TRUE(unlimited.Decode(header_only, &frames));
+  EXPECT_EQ(unlimited.state(), FrameDecoder::State::kBody);
+}
+
+// ----------------------------------------------------------------------------
+// 12. v2 帧头：网络字节序的定长头部，请求id和标志位在protobuf信封之外
+// ----------------------------------------------------------------------------
+TEST(FrameHeaderV2Test, NetworkByteOrderLayout) {
+  FrameHeader header;
+  header.request_id = 0x0102030405060708ULL;
+  header.flags = Codec::kFlagResponse;
+  char encoded[Codec::kMaxHeaderSize];
+  ASSERT_EQ(Codec::EncodeFrameHeader(2, header, 0x1234, encoded),
+            Codec::kHeaderSizeV2);
+
+  const unsigned char expected[] = {
+      'P', 'R', 'P', 'C', 2, Codec::kFlagResponse, 0, 24,
+      1, 2, 3, 4, 5, 6, 7, 8,
+      0, 0, 0x12, 0x34, 0, 0, 0, 0};
+  EXPECT_EQ(memcmp(encoded, expected, sizeof(expected)), 0);
+
+  alignas(8) char aligned[Codec::kHeaderSizeV2];
+  memcpy(aligned, encoded, sizeof(aligned));
+  FrameHeader decoded;
+  int header_size = 0;
+  uint32_t payload_size = 0;
+  ASSERT_TRUE(
+      Codec::DecodeHeaderV2(aligned, &decoded, &header_size, &payload_size));
+  EXPECT_EQ(decoded.request_id, header.request_id);
+  EXPECT_EQ(decoded.flags, header.flags);
+  EXPECT_EQ(header_size, Codec::kHeaderSizeV2);
+  EXPECT_EQ(payload_size, 0x1234u);
+
+  // Version 1 ignores the header fields.
+  EXPECT_EQ(Codec::EncodeFrameHeader(1, header, 5, encoded),
+            Codec::kHeaderSize);
+  int length;
+  memcpy(&length, encoded, 4);
+  EXPECT_EQ(length, 5);
+}
+
+TEST(FrameHeaderV2Test, RejectsBadMagicVersionAndHeaderLength) {
+  FrameHeader header;
+  alignas(8) char encoded[Codec::kHeaderSizeV2];
+  FrameHeader decoded;
+  int header_size;
+  uint32_t payload_size;
+
+  Codec::EncodeFrameHeader(2, header, 1, encoded);
+  encoded[0] = 'X';
+  EXPECT_FALSE(
+      Codec::DecodeHeaderV2(encoded, &decoded, &header_size, &payload_size));
+
+  Codec::EncodeFrameHeader(2, header, 1, encoded);
+  encoded[4] = 3;
+  EXPECT_FALSE(
+      Codec::DecodeHeaderV2(encoded, &decoded, &header_size, &payload_size));
+
+  Codec::EncodeFrameHeader(2, header, 1, encoded);
+  encoded[7] = 20;
+  EXPECT_FALSE(
+      Codec::DecodeHeaderV2(encoded, &decoded, &header_size, &payload_size));
+}
+
+std::string EncodeV2(const std::string& payload, uint64_t request_id) {
+  FrameHeader header;
+  header.request_id = request_id;
+  char encoded[Codec::kMaxHeaderSize];
+  int header_size = Codec::EncodeFrameHeader(
+      2, header, static_cast<int>(payload.size()), encoded);
+  return std::string(encoded, header_size) + payload;
+}
+
+TEST(FrameHeaderV2Test, DecoderCarriesHeaderFields) {
+  std::string stream = EncodeV2("first", 7) + EncodeV2("second", 8);
+  // Split inside the second header, as a ring would.
+  BufferSpans data;
+  data.first = std::string_view(stream).substr(0, 24 + 5 + 10);
+  data.second = std::string_view(stream).substr(24 + 5 + 10);
+
+  FrameDecoder decoder(2);
+  std::vector<FrameView> frames;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(data.Sub(frames[0].offset, frames[0].size).ToString(), "first");
+  EXPECT_EQ(frames[0].header.request_id, 7u);
+  EXPECT_EQ(data.Sub(frames[1].offset, frames[1].size).ToString(), "second");
+  EXPECT_EQ(frames[1].header.request_id, 8u);
+  EXPECT_EQ(decoder.TakeDecoded(), stream.size());
+}
+
+// 更长的header_len：未知的扩展字段被跳过
+TEST(FrameHeaderV2Test, DecoderSkipsHeaderExtensions) {
+  std::string frame = EncodeV2("payload", 9);
+  frame[7] = 32;
+  frame.insert(24, 8, '\xff');
+  BufferSpans data;
+  data.first = std::string_view(frame).substr(0, 28);
+
+  FrameDecoder decoder(2);
+  std::vector<FrameView> frames;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  EXPECT_TRUE(frames.empty());
+  EXPECT_EQ(decoder.state(), FrameDecoder::State::kBody);
+  EXPECT_EQ(decoder.header_size(), 32u);
+  EXPECT_EQ(decoder.Missing(data), frame.size() - 28);
+
+  data.first = frame;
+  ASSERT_TRUE(decoder.Decode(data, &frames));
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(data.Sub(frames[0].offset, frames[0].size).ToString(),
+            "payload");
+
+  // A v1 stream is no valid v2 stream.
+  std::string v1 = Codec::encode(frame);
+  BufferSpans v1_data;
+  v1_data.first = v1;
+  FrameDecoder v2_decoder(2);
+  EXPECT_FALSE(v2_decoder.Decode(v1_data, &frames));
+}
+
+TEST(FrameHeaderV2Test, DecoderRejectsBodyAboveMaximum) {
+  std::string frame = EncodeV2(std::string(100, 'x'), 1);
+  BufferSpans data;
+  data.first = std::string_view(frame).substr(0, Codec::kHeaderSizeV2);
+  std::vector<FrameView> frames;
+  FrameDecoder limited(2, 99);
+  EXPECT_FALSE(limited.Decode(data, &frames));
+  FrameDecoder exact(2, 100);
+  EXPECT_TRUE(exact.Decode(data, &frames));
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+#include "../include/photonrpc/coroutine.h"
+#include "protocol/calculate_service.pb.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// 模拟客户端EventLoop：在另一个线程中完成调用并运行done
+class FakeChannel : public google::protobuf::RpcChannel {
+ public:
+  ~FakeChannel() override {
+    // A call made from a completion thread may still be registering itself.
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void CallMethod(const google::protobuf::MethodDescriptor* method,
+                  google::protobuf::RpcController* controller,
+                  const google::protobuf::Message* request,
+                  google::protobuf::Message* response,
+                  google::protobuf::Closure* done) override {
+    call_count_++;
+    auto add_request = static_cast<const rpc::AddRequest*>(request);
+    int a = add_request->a();
+    int b = add_request->b();
+    bool is_add = method->name() == "Add";
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.emplace_back([=] {
+      auto add_response = static_cast<rpc::AddResponse*>(response);
+      add_response->set_result(is_add ? a + b : a - b);
+      done->Run();
+    });
+  }
+
+  int call_count() const { return call_count_; }
+
+ private:
+  std::atomic<int> call_count_{0};
+  std::mutex mutex_;
+  std::vector<std::thread> threads_;
+};
+
+class CalculateStub : public AwaitableStub<rpc::CalculateService_Stub> {
+ public:
+  using AwaitableStub::AwaitableStub;
+
+  PHOTONRPC_AWAITABLE_METHOD(Add)
+  PHOTONRPC_AWAITABLE_METHOD(Sub)
+};
+
+Task<int> Constant(int value) {
+  co_return value;
+}
+
+Task<int> AddConstants() {
+  int a = co_await Constant(5);
+  int b = co_await Constant(6);
+  co_return a + b;
+}
+
+// ----------------------------------------------------------------------------
+// 1. Task 基础
+// ----------------------------------------------------------------------------
+
+TEST(TaskTest, ReturnsValue) {
+  EXPECT_EQ(SyncWait(Constant(42)), 42);
+}
+
+TEST(TaskTest, AwaitsNestedTasks) {
+  EXPECT_EQ(SyncWait(AddConstants()), 11);
+}
+
+TEST(TaskTest, PropagatesException) {
+  auto failing = []() -> Task<int> {
+    throw std::runtime_error("boom");
+    co_return 0;
+  };
+  EXPECT_THROW(SyncWait(failing()), std::runtime_error);
+}
+
+TEST(TaskTest, IsLazy) {
+  bool started = false;
+  auto task = [](bool* started) -> Task<void> {
+    *started = true;
+    co_return;
+  }(&started);
+  EXPECT_FALSE(started);
+  SyncWait(std::move(task));
+  EXPECT_TRUE(started);
+}
+
+// ----------------------------------------------------------------------------
+// 2. RPC 调用的 awaitable 形式
+// ----------------------------------------------------------------------------
+
+TEST(AwaitableCallTest, RpcCallResumesOnCompletion) {
+  FakeChannel channel;
+  auto call = [](FakeChannel* channel) -> Task<int> {
+    rpc::AddRequest request;
+    request.set_a(2);
+    request.set_b(3);
+    rpc::AddResponse response;
+    co_await RpcCall(channel,
+                     rpc::CalculateService::descriptor()->FindMethodByName(
+                         "Add"),
+                     nullptr, &request, &response);
+    co_return response.result();
+  };
+  EXPECT_EQ(SyncWait(call(&channel)), 5);
+}
+
+TEST(AwaitableCallTest, StubCall) {
+  FakeChannel channel;
+  auto call = [](FakeChannel* channel) -> Task<int> {
+    AwaitableStub<rpc::CalculateService_Stub> stub(channel);
+    rpc::AddRequest request;
+    request.set_a(5);
+    request.set_b(6);
+    rpc::AddResponse response =
+        co_await stub.Call(&rpc::CalculateService_Stub::Add, request);
+    co_return response.result();
+  };
+  EXPECT_EQ(SyncWait(call(&channel)), 11);
+}
+
+TEST(AwaitableCallTest, NamedStubMethods) {
+  FakeChannel channel;
+  auto call = [](FakeChannel* channel) -> Task<int> {
+    CalculateStub stub(channel);
+    rpc::AddRequest add_request;
+    add_request.set_a(5);
+    add_request.set_b(6);
+    rpc::SubRequest sub_request;
+    sub_request.set_a(5);
+    sub_request.set_b(6);
+    int sum = (co_await stub.Add(add_request)).result();
+    int difference = (co_await stub.Sub(sub_request)).result();
+    co_return sum * 10 + difference;
+  };
+  EXPECT_EQ(SyncWait(call(&channel)), 109);
+  EXPECT_EQ(channel.call_count(), 2);
+}
+
+// 3. 扇出：大量并发调用，只占用协程帧，不占用线程
+TEST(AwaitableCallTest, FanOut) {
+  FakeChannel channel;
+  auto fan_out = [](FakeChannel* channel) -> Task<int> {
+    CalculateStub stub(channel);
+    std::vector<Task<rpc::AddResponse>> calls;
+    for (int i = 0; i < 100; i++) {
+      rpc::AddRequest request;
+      request.set_a(i);
+      request.set_b(1);
+      calls.push_back(stub.Add(request));
+    }
+    int total = 0;
+    for (auto& response : co_await WhenAll(std::move(calls))) {
+      total += response.result();
+    }
+    co_return total;
+  };
+  EXPECT_EQ(SyncWait(fan_out(&channel)), 5050);
+  EXPECT_EQ(channel.call_count(), 100);
+}
+
+TEST(WhenAllTest, EmptyAndImmediate) {
+  EXPECT_TRUE(SyncWait(WhenAll(std::vector<Task<int>>())).empty());
+
+  std::vector<Task<int>> tasks;
+  tasks.push_back(Constant(1));
+  tasks.push_back(Constant(2));
+  EXPECT_EQ(SyncWait(WhenAll(std::move(tasks))), std::vector<int>({1, 2}));
+}
+
+// ----------------------------------------------------------------------------
+// 4. 服务端协程：CoSpawn 在任务结束后运行 done
+// ----------------------------------------------------------------------------
+
+void NotifyDone(std::promise<void>* finished) {
+  finished->set_value();
+}
+
+Task<void> SubThroughAdd(FakeChannel* channel, const rpc::SubRequest* request,
+                         rpc::SubResponse* response) {
+  CalculateStub stub(channel);
+  rpc::AddRequest add_request;
+  add_request.set_a(request->a());
+  add_request.set_b(-request->b());
+  response->set_result((co_await stub.Add(add_request)).result());
+}
+
+TEST(CoSpawnTest, RunsDoneAfterSuspendedTask) {
+  FakeChannel channel;
+  rpc::SubRequest request;
+  request.set_a(9);
+  request.set_b(4);
+  rpc::SubResponse response;
+  std::promise<void> finished;
+
+  CoSpawn(SubThroughAdd(&channel, &request, &response),
+          google::protobuf::NewCallback(&NotifyDone, &finished));
+  finished.get_future().wait();
+  EXPECT_EQ(response.result(), 5);
+}
+
+TEST(CoSpawnTest, RunsDoneWhenTaskThrows) {
+  auto failing = []() -> Task<void> {
+    throw std::runtime_error("boom");
+    co_return;
+  };
+  std::promise<void> finished;
+  std::future<void> done = finished.get_future();
+  CoSpawn(failing(), google::protobuf::NewCallback(&NotifyDone, &finished));
+  EXPECT_EQ(done.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+}
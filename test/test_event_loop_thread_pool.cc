@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include "../src/core/net/event_loop_thread_pool.h"
+
+#include <set>
+
+TEST(EventLoopThreadPoolTest, ParseDispatchPolicy) {
+  EXPECT_EQ(EventLoopThreadPool::ParseDispatchPolicy("least_connections"),
+            EventLoopThreadPool::DispatchPolicy::kLeastConnections);
+  EXPECT_EQ(EventLoopThreadPool::ParseDispatchPolicy("round_robin"),
+            EventLoopThreadPool::DispatchPolicy::kRoundRobin);
+  EXPECT_EQ(EventLoopThreadPool::ParseDispatchPolicy(""),
+            EventLoopThreadPool::DispatchPolicy::kRoundRobin);
+}
+
+// 轮询：依次分配到每个I/O线程，然后从头开始
+TEST(EventLoopThreadPoolTest, RoundRobinCyclesThroughLoops) {
+  EventLoop base_loop;
+  EventLoopThreadPool pool(&base_loop, 3,
+                           EventLoopThreadPool::DispatchPolicy::kRoundRobin);
+  pool.Start();
+
+  std::set<EventLoop*> loops;
+  for (int i = 0; i < 3; i++) {
+    EventLoop* loop = pool.GetNextLoop();
+    EXPECT_EQ(loop, pool.GetLoop(i));
+    EXPECT_NE(loop, &base_loop);
+    loops.insert(loop);
+  }
+  EXPECT_EQ(loops.size(), 3u);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(i % 3));
+  }
+
+  // 关闭连接不影响轮询顺序
+  pool.ReleaseLoop(pool.GetLoop(2));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(0));
+  pool.Stop();
+}
+
+// 最少连接：总是选择当前连接数最少的线程，相同时选编号小的
+TEST(EventLoopThreadPoolTest, LeastConnectionsPicksLeastLoaded) {
+  EventLoop base_loop;
+  EventLoopThreadPool pool(
+      &base_loop, 3, EventLoopThreadPool::DispatchPolicy::kLeastConnections);
+  pool.Start();
+
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(0));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(1));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(2));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(0));
+
+  // 线程1上的连接关闭后，新连接分配到线程1
+  pool.ReleaseLoop(pool.GetLoop(1));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(1));
+
+  // 在线程2自己接受的连接（reuseport）同样计入
+  pool.ReleaseLoop(pool.GetLoop(2));
+  pool.AcquireLoop(pool.GetLoop(2));
+  pool.AcquireLoop(pool.GetLoop(2));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(1));
+  EXPECT_EQ(pool.GetNextLoop(), pool.GetLoop(0));
+  pool.Stop();
+}
+
+// io_thread_num = 0：没有I/O线程，所有连接都由主循环处理
+TEST(EventLoopThreadPoolTest, NoThreadsFallsBackToBaseLoop) {
+  for (auto policy : {EventLoopThreadPool::DispatchPolicy::kRoundRobin,
+                      EventLoopThreadPool::DispatchPolicy::kLeastConnections}) {
+    EventLoop base_loop;
+    EventLoopThreadPool pool(&base_loop, 0, policy);
+    pool.Start();
+    EXPECT_EQ(pool.thread_num(), 0);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_EQ(pool.GetNextLoop(), &base_loop);
+    }
+    pool.ReleaseLoop(&base_loop);
+    EXPECT_EQ(pool.GetNextLoop(), &base_loop);
+    pool.Stop();
+  }
+
+  // 负数同样视为0
+  EventLoop base_loop;
+  EventLoopThreadPool pool(&base_loop, -1,
+                           EventLoopThreadPool::DispatchPolicy::kRoundRobin);
+  pool.Start();
+  EXPECT_EQ(pool.thread_num(), 0);
+  EXPECT_EQ(pool.GetNextLoop(), &base_loop);
+}
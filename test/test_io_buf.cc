@@ -0,0 +1,570 @@
+#include <gtest/gtest.h>
+#include "../src/core/net/io_buf.h"
+#include "../src/core/rpc/rpc_codec.h"
+#include "../src/core/rpc/buffer_stream.h"
+#include "../src/core/rpc/io_buf_stream.h"
+#include "protocol/echo_service.pb.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+std::string Pattern(size_t size) {
+  std::string data(size, '\0');
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  return data;
+}
+
+// ----------------------------------------------------------------------------
+// 1. 追加与拷贝
+// ----------------------------------------------------------------------------
+
+TEST(IoBufTest, AppendSpansBlocks) {
+  std::string data = Pattern(IoBuf::kBlockSize * 2 + 100);
+  IoBuf buf;
+  buf.Append(data);
+
+  EXPECT_EQ(buf.size(), data.size());
+  EXPECT_EQ(buf.segment_count(), 3);
+  EXPECT_EQ(buf.ToString(), data);
+}
+
+TEST(IoBufTest, SmallAppendsShareTheTailBlock) {
+  IoBuf buf;
+  buf.Append("abc");
+  buf.Append("def");
+  EXPECT_EQ(buf.segment_count(), 1);
+  EXPECT_EQ(buf.ToString(), "abcdef");
+}
+
+TEST(IoBufTest, CopySharesBlocks) {
+  IoBuf buf;
+  buf.Append("shared");
+  IoBuf copy(buf);
+
+  EXPECT_EQ(copy.segment(0).data(), buf.segment(0).data());
+  // 共享的块不可再追加，新数据进入新块
+  copy.Append("!");
+  EXPECT_EQ(copy.ToString(), "shared!");
+  EXPECT_EQ(buf.ToString(), "shared");
+}
+
+TEST(IoBufTest, CopyOfBorrowedBytesOwnsThem) {
+  std::string external = "borrowed";
+  IoBuf view;
+  view.AppendBorrowed(external.data(), external.size());
+  EXPECT_EQ(view.segment(0).data(), external.data());
+
+  IoBuf copy(view);
+  external.assign("xxxxxxxx");
+  EXPECT_EQ(copy.ToString(), "borrowed");
+}
+
+TEST(IoBufTest, MoveLeavesSourceEmpty) {
+  IoBuf buf;
+  buf.Append("moved");
+  IoBuf target(std::move(buf));
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(target.ToString(), "moved");
+
+  IoBuf other;
+  other.Append("head ");
+  other.Append(std::move(target));
+  EXPECT_TRUE(target.empty());
+  EXPECT_EQ(other.ToString(), "head moved");
+}
+
+// ----------------------------------------------------------------------------
+// 2. 切分：只移动块的引用
+// ----------------------------------------------------------------------------
+
+TEST(IoBufTest, CutSplitsWithoutCopy) {
+  std::string data = Pattern(IoBuf::kBlockSize + 10);
+  IoBuf buf;
+  buf.Append(data);
+  const char* first = buf.segment(0).data();
+
+  IoBuf head;
+  buf.Cut(100, &head);
+  EXPECT_EQ(head.ToString(), data.substr(0, 100));
+  EXPECT_EQ(buf.ToString(), data.substr(100));
+  EXPECT_EQ(head.segment(0).data(), first);
+  EXPECT_EQ(buf.segment(0).data(), first + 100);
+
+  IoBuf rest;
+  buf.Cut(buf.size() + 1, &rest);
+  EXPECT_TRUE(buf.empty());
+  EXPECT_EQ(rest.ToString(), data.substr(100));
+}
+
+TEST(IoBufTest, PopFrontAndCopyTo) {
+  std::string data = Pattern(IoBuf::kBlockSize * 3);
+  IoBuf buf;
+  buf.Append(data);
+  buf.PopFront(IoBuf::kBlockSize + 5);
+  EXPECT_EQ(buf.size(), data.size() - IoBuf::kBlockSize - 5);
+
+  std::string middle(IoBuf::kBlockSize, '\0');
+  buf.CopyTo(10, middle.size(), middle.data());
+  EXPECT_EQ(middle, data.substr(IoBuf::kBlockSize + 15, middle.size()));
+}
+
+TEST(IoBufTest, AppendInPlaceAndTrimBack) {
+  IoBuf buf;
+  buf.Append("x");
+  size_t size;
+  char* data = buf.AppendInPlace(&size);
+  EXPECT_EQ(size, IoBuf::kBlockSize - 1);
+  data[0] = 'y';
+  buf.TrimBack(size - 1);
+  EXPECT_EQ(buf.ToString(), "xy");
+}
+
+// ----------------------------------------------------------------------------
+// 3. ReadFd / WriteFd
+// ----------------------------------------------------------------------------
+
+TEST(IoBufFdTest, WriteThenReadThroughSocket) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+  std::string data = Pattern(IoBuf::kBlockSize * 4 + 7);
+  IoBuf output;
+  output.Append("head");
+  output.Append(data);
+  IoBuf received;
+  while (!output.empty() || received.size() < data.size() + 4) {
+    if (!output.empty()) {
+      output.WriteFd(fds[0]);
+    }
+    received.ReadFd(fds[1], data.size() + 4 - received.size());
+  }
+  EXPECT_EQ(received.ToString(), "head" + data);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST(IoBufFdTest, ReadFdStopsAtMaxSize) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  ASSERT_EQ(write(fds[0], "0123456789", 10), 10);
+
+  IoBuf buf;
+  EXPECT_EQ(buf.ReadFd(fds[1], 4), 4);
+  EXPECT_EQ(buf.ReadFd(fds[1], 100), 6);
+  EXPECT_EQ(buf.ToString(), "0123456789");
+  EXPECT_EQ(buf.segment_count(), 1);
+
+  close(fds[1]);
+  EXPECT_EQ(buf.ReadFd(fds[0], 100), 0);
+  close(fds[0]);
+}
+
+TEST(IoBufFdTest, WriteFdMovesSentBytesOut) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+  std::string data = Pattern(IoBuf::kBlockSize + 100);
+  IoBuf output;
+  output.Append(data);
+  const char* first_block = output.segment(0).data();
+  IoBuf sent;
+  ASSERT_EQ(output.WriteFd(fds[0], 0, &sent),
+            static_cast<ssize_t>(data.size()));
+  EXPECT_TRUE(output.empty());
+  // The very blocks that were handed to the kernel.
+  EXPECT_EQ(sent.segment(0).data(), first_block);
+  EXPECT_EQ(sent.ToString(), data);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+// MSG_ZEROCOPY reports its completions on the error queue; loopback copies
+// and says so with SO_EE_CODE_ZEROCOPY_COPIED.
+TEST(IoBufFdTest, ZerocopyCompletionOnErrorQueue) {
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  ASSERT_EQ(bind(listen_fd, reinterpret_cast<sockaddr*>(&address), length),
+            0);
+  ASSERT_EQ(listen(listen_fd, 1), 0);
+  getsockname(listen_fd, reinterpret_cast<sockaddr*>(&address), &length);
+  int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(connect(client_fd, reinterpret_cast<sockaddr*>(&address), length),
+            0);
+  int server_fd = accept(listen_fd, nullptr, nullptr);
+  ASSERT_GE(server_fd, 0);
+  int on = 1;
+  if (setsockopt(client_fd, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) != 0) {
+    close(server_fd);
+    close(client_fd);
+    close(listen_fd);
+    GTEST_SKIP() << "SO_ZEROCOPY not supported";
+  }
+
+  std::string data = Pattern(IoBuf::kBlockSize * 3);
+  IoBuf output;
+  output.Append(data);
+  IoBuf sent;
+  ASSERT_EQ(output.WriteFd(client_fd, MSG_ZEROCOPY, &sent),
+            static_cast<ssize_t>(data.size()));
+  IoBuf received;
+  while (received.size() < data.size()) {
+    ASSERT_GT(received.ReadFd(server_fd, data.size() - received.size()), 0);
+  }
+  EXPECT_EQ(received.ToString(), data);
+
+  struct pollfd poll_fd = {client_fd, 0, 0};
+  ASSERT_EQ(poll(&poll_fd, 1, 1000), 1);
+  EXPECT_TRUE(poll_fd.revents & POLLERR);
+  char control[CMSG_SPACE(sizeof(struct sock_extended_err))];
+  struct msghdr message = {};
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  ASSERT_EQ(recvmsg(client_fd, &message, MSG_ERRQUEUE), 0);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  ASSERT_NE(cmsg, nullptr);
+  struct sock_extended_err error;
+  memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+  EXPECT_EQ(error.ee_origin, SO_EE_ORIGIN_ZEROCOPY);
+  // The first zero-copy send of the socket is number 0.
+  EXPECT_EQ(error.ee_info, 0u);
+  EXPECT_EQ(error.ee_data, 0u);
+  sent.Clear();
+
+  close(server_fd);
+  close(client_fd);
+  close(listen_fd);
+}
+
+// ----------------------------------------------------------------------------
+// 4. protobuf 直接在块链上解析和序列化
+// ----------------------------------------------------------------------------
+
+TEST(IoBufStreamTest, SerializeAndParseAcrossBlocks) {
+  rpc::EchoRequest request;
+  request.set_sentence(Pattern(IoBuf::kBlockSize * 3 + 11));
+
+  IoBuf buf;
+  {
+    IoBufOutputStream output(&buf);
+    ASSERT_TRUE(request.SerializeToZeroCopyStream(&output));
+  }
+  EXPECT_EQ(buf.size(), request.ByteSizeLong());
+  EXPECT_GT(buf.segment_count(), 1);
+
+  rpc::EchoRequest parsed;
+  ASSERT_TRUE(ParseMessage(buf, &parsed));
+  EXPECT_EQ(parsed.sentence(), request.sentence());
+}
+
+TEST(IoBufStreamTest, ParseBorrowedSegments) {
+  rpc::EchoRequest request;
+  request.set_sentence("split across two views");
+  std::string data = request.SerializeAsString();
+
+  IoBuf buf;
+  buf.AppendBorrowed(data.data(), 5);
+  buf.AppendBorrowed(data.data() + 5, data.size() - 5);
+  rpc::EchoRequest parsed;
+  ASSERT_TRUE(ParseMessage(buf, &parsed));
+  EXPECT_EQ(parsed.sentence(), request.sentence());
+}
+
+TEST(IoBufStreamTest, InputStreamBackUpAndSkip) {
+  IoBuf buf;
+  buf.AppendBorrowed("abcd", 4);
+  buf.AppendBorrowed("efgh", 4);
+  IoBufInputStream input(buf);
+
+  const void* data;
+  int size;
+  ASSERT_TRUE(input.Next(&data, &size));
+  EXPECT_EQ(size, 4);
+  input.BackUp(2);
+  ASSERT_TRUE(input.Skip(3));
+  ASSERT_TRUE(input.Next(&data, &size));
+  EXPECT_EQ(std::string(static_cast<const char*>(data), size), "fgh");
+  EXPECT_EQ(input.ByteCount(), 8);
+  EXPECT_FALSE(input.Next(&data, &size));
+}
+
+// ----------------------------------------------------------------------------
+// 5. 信封与负载一次写入输出缓冲区
+// ----------------------------------------------------------------------------
+
+rpc::RpcMessage ResponseEnvelope(uint32_t id) {
+  rpc::RpcMessage envelope;
+  envelope.set_id(id);
+  envelope.set_type(rpc::RPC_TYPE_RESPONSE);
+  return envelope;
+}
+
+TEST(EnvelopeTest, MatchesRegularSerialization) {
+  rpc::EchoResponse response;
+  response.set_result("in place");
+  rpc::RpcMessage envelope = ResponseEnvelope(7);
+  size_t response_size = response.ByteSizeLong();
+  size_t size = EnvelopeSize(envelope, rpc::RpcMessage::kResponseFieldNumber,
+                             response_size);
+
+  Buffer buffer(64);
+  {
+    BufferOutputStream output(&buffer);
+    SerializeEnvelope(envelope, rpc::RpcMessage::kResponseFieldNumber,
+                      response, response_size, &output);
+  }
+
+  rpc::RpcMessage expected = ResponseEnvelope(7);
+  expected.set_response(response.SerializeAsString());
+  EXPECT_EQ(buffer.PeekData(), expected.SerializeAsString());
+  EXPECT_EQ(static_cast<size_t>(buffer.GetSize()), size);
+}
+
+TEST(EnvelopeTest, EmptyPayloadIsOmitted) {
+  rpc::RpcMessage envelope = ResponseEnvelope(1);
+  EXPECT_EQ(EnvelopeSize(envelope, rpc::RpcMessage::kResponseFieldNumber, 0),
+            envelope.ByteSizeLong());
+}
+
+TEST(EnvelopeTest, WrapsAroundTheRing) {
+  rpc::EchoResponse response;
+  response.set_result(Pattern(100));
+  size_t response_size = response.ByteSizeLong();
+  rpc::RpcMessage envelope = ResponseEnvelope(3);
+
+  Buffer buffer(256);
+  std::string filler(200, 'f');
+  buffer.WriteData(filler, filler.size());
+  buffer.RetrieveData(filler.size());
+  {
+    BufferOutputStream output(&buffer);
+    SerializeEnvelope(envelope, rpc::RpcMessage::kResponseFieldNumber,
+                      response, response_size, &output);
+  }
+  EXPECT_FALSE(buffer.PeekSpans().contiguous());
+  EXPECT_EQ(buffer.GetCapacity(), 256);
+
+  rpc::RpcMessage parsed;
+  ASSERT_TRUE(parsed.ParseFromString(buffer.PeekData()));
+  rpc::EchoResponse parsed_response;
+  ASSERT_TRUE(parsed_response.ParseFromString(parsed.response()));
+  EXPECT_EQ(parsed.id(), 3u);
+  EXPECT_EQ(parsed_response.result(), response.result());
+}
+
+TEST(EnvelopeTest, IntoBlockChain) {
+  rpc::EchoResponse response;
+  response.set_result(Pattern(IoBuf::kBlockSize * 2));
+  size_t response_size = response.ByteSizeLong();
+  rpc::RpcMessage envelope = ResponseEnvelope(9);
+  size_t size = EnvelopeSize(envelope, rpc::RpcMessage::kResponseFieldNumber,
+                             response_size);
+
+  IoBuf chain;
+  {
+    IoBufOutputStream output(&chain);
+    SerializeEnvelope(envelope, rpc::RpcMessage::kResponseFieldNumber,
+                      response, response_size, &output);
+  }
+  EXPECT_EQ(chain.size(), size);
+  rpc::RpcMessage parsed;
+  ASSERT_TRUE(ParseMessage(chain, &parsed));
+  EXPECT_EQ(parsed.id(), 9u);
+}
+
+// ----------------------------------------------------------------------------
+// 6. 在接收缓冲区上原地解析信封和请求
+// ----------------------------------------------------------------------------
+
+rpc::RpcMessage RequestEnvelope(const rpc::EchoRequest& request) {
+  rpc::RpcMessage envelope;
+  envelope.set_id(42);
+  envelope.set_type(rpc::RPC_TYPE_REQUEST);
+  envelope.set_service_name("EchoService");
+  envelope.set_method_name("Echo");
+  envelope.set_request(request.SerializeAsString());
+  return envelope;
+}
+
+void ExpectRequestParsed(const IoBuf& frame, const rpc::EchoRequest& request) {
+  rpc::RpcMessage envelope;
+  size_t offset;
+  size_t size;
+  ASSERT_TRUE(ParseEnvelope(frame, rpc::RpcMessage::kRequestFieldNumber,
+                            &envelope, &offset, &size));
+  EXPECT_EQ(envelope.id(), 42u);
+  EXPECT_EQ(envelope.type(), rpc::RPC_TYPE_REQUEST);
+  EXPECT_EQ(envelope.service_name(), "EchoService");
+  EXPECT_EQ(envelope.method_name(), "Echo");
+  // 负载没有被拷贝进信封
+  EXPECT_TRUE(envelope.request().empty());
+  EXPECT_EQ(size, request.ByteSizeLong());
+
+  rpc::EchoRequest parsed;
+  ASSERT_TRUE(ParseMessage(frame, offset, size, &parsed));
+  EXPECT_EQ(parsed.sentence(), request.sentence());
+}
+
+TEST(ParseEnvelopeTest, ContiguousFrame) {
+  rpc::EchoRequest request;
+  request.set_sentence("parsed in place");
+  std::string data = RequestEnvelope(request).SerializeAsString();
+  IoBuf frame;
+  frame.AppendBorrowed(data.data(), data.size());
+  ExpectRequestParsed(frame, request);
+}
+
+TEST(ParseEnvelopeTest, FrameSplitAcrossSegments) {
+  rpc::EchoRequest request;
+  request.set_sentence(Pattern(300));
+  std::string data = RequestEnvelope(request).SerializeAsString();
+  // 在每个位置切开，覆盖信封字段和负载跨段的情况
+  for (size_t cut = 1; cut < data.size(); cut += 7) {
+    IoBuf frame;
+    frame.AppendBorrowed(data.data(), cut);
+    frame.AppendBorrowed(data.data() + cut, data.size() - cut);
+    ExpectRequestParsed(frame, request);
+  }
+}
+
+TEST(ParseEnvelopeTest, MissingPayloadAndMalformedFrames) {
+  rpc::RpcMessage envelope;
+  envelope.set_id(1);
+  envelope.set_type(rpc::RPC_TYPE_REQUEST);
+  std::string data = envelope.SerializeAsString();
+  IoBuf frame;
+  frame.AppendBorrowed(data.data(), data.size());
+  rpc::RpcMessage parsed;
+  size_t offset;
+  size_t size;
+  ASSERT_TRUE(ParseEnvelope(frame, rpc::RpcMessage::kRequestFieldNumber,
+                            &parsed, &offset, &size));
+  EXPECT_EQ(size, 0u);
+
+  // 负载长度超出帧
+  std::string truncated =
+      RequestEnvelope(rpc::EchoRequest()).SerializeAsString();
+  truncated += "\x2a\x10short";
+  IoBuf bad;
+  bad.AppendBorrowed(truncated.data(), truncated.size());
+  EXPECT_FALSE(ParseEnvelope(bad, rpc::RpcMessage::kRequestFieldNumber,
+                             &parsed, &offset, &size));
+}
+
+TEST(ParseEnvelopeTest, NegotiatedMethodId) {
+  rpc::EchoRequest request;
+  request.set_sentence("by id");
+  rpc::RpcMessage envelope;
+  envelope.set_id(42);
+  envelope.set_type(rpc::RPC_TYPE_REQUEST);
+  envelope.set_method_id(7);
+  envelope.set_request(request.SerializeAsString());
+  std::string data = envelope.SerializeAsString();
+  IoBuf frame;
+  frame.AppendBorrowed(data.data(), data.size());
+
+  rpc::RpcMessage parsed;
+  size_t offset;
+  size_t size;
+  ASSERT_TRUE(ParseEnvelope(frame, rpc::RpcMessage::kRequestFieldNumber,
+                            &parsed, &offset, &size));
+  ASSERT_TRUE(parsed.has_method_id());
+  EXPECT_EQ(parsed.method_id(), 7u);
+  EXPECT_TRUE(parsed.service_name().empty());
+  EXPECT_EQ(size, request.ByteSizeLong());
+
+  // Names only: no ID.
+  data = RequestEnvelope(request).SerializeAsString();
+  IoBuf named;
+  named.AppendBorrowed(data.data(), data.size());
+  rpc::RpcMessage parsed_named;
+  ASSERT_TRUE(ParseEnvelope(named, rpc::RpcMessage::kRequestFieldNumber,
+                            &parsed_named, &offset, &size));
+  EXPECT_FALSE(parsed_named.has_method_id());
+}
+
+// ----------------------------------------------------------------------------
+// 7. 紧凑信封：定长头部后直接跟用户消息，按方法哈希分发
+// ----------------------------------------------------------------------------
+
+TEST(CompactEnvelopeTest, MethodKeyIsFnv1a) {
+  EXPECT_EQ(MethodKey(""), 0xcbf29ce484222325ULL);
+  EXPECT_EQ(MethodKey("a"), 0xaf63dc4c8601ec8cULL);
+  EXPECT_NE(MethodKey("EchoService.Echo"), MethodKey("EchoService.Echo2"));
+}
+
+TEST(CompactEnvelopeTest, NetworkByteOrderLayout) {
+  CompactEnvelope envelope;
+  envelope.type = rpc::RPC_TYPE_REQUEST;
+  envelope.status = kStatusInvalidRequest;
+  envelope.flags = kEnvelopeMethodId;
+  envelope.id = 0x01020304;
+  envelope.method_key = 0x1112131415161718ULL;
+  envelope.deadline_ms = 0x21222324;
+  char encoded[kCompactEnvelopeSize];
+  EncodeCompactEnvelope(envelope, encoded);
+  const unsigned char expected[] = {
+      rpc::RPC_TYPE_REQUEST, kStatusInvalidRequest, kEnvelopeMethodId, 0,
+      1, 2, 3, 4,
+      0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+      0x21, 0x22, 0x23, 0x24, 0, 0, 0, 0};
+  EXPECT_EQ(memcmp(encoded, expected, sizeof(expected)), 0);
+
+  // Split across segments.
+  IoBuf frame;
+  frame.AppendBorrowed(encoded, 5);
+  frame.AppendBorrowed(encoded + 5, kCompactEnvelopeSize - 5);
+  CompactEnvelope decoded;
+  ASSERT_TRUE(DecodeCompactEnvelope(frame, &decoded));
+  EXPECT_EQ(decoded.type, envelope.type);
+  EXPECT_EQ(decoded.status, envelope.status);
+  EXPECT_EQ(decoded.flags, envelope.flags);
+  EXPECT_EQ(decoded.id, envelope.id);
+  EXPECT_EQ(decoded.method_key, envelope.method_key);
+  EXPECT_EQ(decoded.deadline_ms, envelope.deadline_ms);
+
+  IoBuf short_frame;
+  short_frame.AppendBorrowed(encoded, kCompactEnvelopeSize - 1);
+  EXPECT_FALSE(DecodeCompactEnvelope(short_frame, &decoded));
+}
+
+TEST(CompactEnvelopeTest, PayloadFollowsTheHeader) {
+  rpc::EchoResponse response;
+  response.set_result(std::string(IoBuf::kBlockSize, 'c'));
+  size_t response_size = response.ByteSizeLong();
+  CompactEnvelope envelope;
+  envelope.type = rpc::RPC_TYPE_RESPONSE;
+  envelope.id = 42;
+
+  IoBuf frame;
+  {
+    IoBufOutputStream output(&frame);
+    SerializeCompact(envelope, response, &output);
+  }
+  ASSERT_EQ(frame.size(), kCompactEnvelopeSize + response_size);
+  EXPECT_GT(frame.segment_count(), 1);
+
+  CompactEnvelope decoded;
+  ASSERT_TRUE(DecodeCompactEnvelope(frame, &decoded));
+  EXPECT_EQ(decoded.id, 42u);
+  rpc::EchoResponse parsed;
+  ASSERT_TRUE(ParseMessage(frame, kCompactEnvelopeSize, response_size,
+                           &parsed));
+  EXPECT_EQ(parsed.result(), response.result());
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "../src/core/rpc/method_table.h"
+#include "../src/core/rpc/rpc_codec.h"
+#include "protocol/calculate_service.pb.h"
+#include "protocol/echo_service.pb.h"
+
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+class EchoServiceImpl : public rpc::EchoService {};
+class CalculateServiceImpl : public rpc::CalculateService {};
+}  // namespace
+
+// ----------------------------------------------------------------------------
+// 1. PerfectHash：每个键一个槽位，互不冲突
+// ----------------------------------------------------------------------------
+
+TEST(PerfectHashTest, EveryKeyFindsItsIndex) {
+  std::mt19937_64 random(7);
+  std::set<uint64_t> unique;
+  while (unique.size() < 1000) {
+    unique.insert(random());
+  }
+  std::vector<uint64_t> keys(unique.begin(), unique.end());
+  PerfectHash hash;
+  hash.Build(keys);
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(hash.Lookup(keys[i]), i);
+  }
+}
+
+TEST(PerfectHashTest, EmptyFindsNothing) {
+  PerfectHash hash;
+  EXPECT_EQ(hash.Lookup(1), PerfectHash::kNotFound);
+  hash.Build({});
+  EXPECT_EQ(hash.Lookup(1), PerfectHash::kNotFound);
+}
+
+// ----------------------------------------------------------------------------
+// 2. MethodTable：连续的方法ID，按名字或MethodKey查找
+// ----------------------------------------------------------------------------
+
+TEST(MethodTableTest, DenseIdsInRegistrationOrder) {
+  EchoServiceImpl echo;
+  CalculateServiceImpl calculate;
+  MethodTable table;
+  table.Register(&echo);
+  table.Register(&calculate);
+  ASSERT_EQ(table.size(), 3u);
+
+  const MethodTable::Entry* entry = table.Get(0);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->service, &echo);
+  EXPECT_EQ(entry->method->name(), "Echo");
+  EXPECT_EQ(entry->request_prototype->GetDescriptor(),
+            rpc::EchoRequest::descriptor());
+  EXPECT_EQ(entry->response_prototype->GetDescriptor(),
+            rpc::EchoResponse::descriptor());
+  EXPECT_EQ(table.Get(2)->method->name(), "Sub");
+  EXPECT_EQ(table.Get(3), nullptr);
+}
+
+TEST(MethodTableTest, FindByNameAndKey) {
+  EchoServiceImpl echo;
+  CalculateServiceImpl calculate;
+  MethodTable table;
+  table.Register(&echo);
+  table.Register(&calculate);
+
+  EXPECT_EQ(table.FindByName("EchoService", "Echo"), 0u);
+  EXPECT_EQ(table.FindByName("CalculateService", "Add"), 1u);
+  EXPECT_EQ(table.FindByName("CalculateService", "Sub"), 2u);
+  EXPECT_EQ(table.FindByKey(MethodKey("rpc.CalculateService.Sub")), 2u);
+  EXPECT_EQ(MethodKey("EchoService", "Echo"), MethodKey("EchoService.Echo"));
+
+  EXPECT_EQ(table.FindByName("EchoService", "Add"), MethodTable::kInvalidId);
+  EXPECT_EQ(table.FindByName("", ""), MethodTable::kInvalidId);
+  EXPECT_EQ(table.FindByKey(MethodKey("CalculateService.Sub")),
+            MethodTable::kInvalidId);
+}
+
+TEST(MethodTableTest, FindByFullName) {
+  EchoServiceImpl echo;
+  CalculateServiceImpl calculate;
+  MethodTable table;
+  table.Register(&echo);
+  table.Register(&calculate);
+
+  EXPECT_EQ(table.FindByFullName("rpc.EchoService.Echo"), 0u);
+  EXPECT_EQ(table.FindByFullName("rpc.CalculateService.Sub"), 2u);
+  EXPECT_EQ(table.FindByFullName("rpc.CalculateService.Mul"),
+            MethodTable::kInvalidId);
+  EXPECT_EQ(table.FindByFullName("EchoService.Echo"), MethodTable::kInvalidId);
+  EXPECT_EQ(table.FindByFullName(""), MethodTable::kInvalidId);
+}
+
+TEST(MethodTableTest, SecondRegistrationIsSkipped) {
+  EchoServiceImpl first;
+  EchoServiceImpl second;
+  MethodTable table;
+  table.Register(&first);
+  table.Register(&second);
+  ASSERT_EQ(table.size(), 1u);
+  EXPECT_EQ(table.Get(table.FindByName("EchoService", "Echo"))->service,
+            &first);
+}
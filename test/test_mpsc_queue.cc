@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include "../src/core/common/mpsc_queue.h"
+#include "../src/core/net/event_loop_thread.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+TEST(MpscQueueTest, FifoSingleThread) {
+  MpscQueue<int> queue;
+  EXPECT_TRUE(queue.Empty());
+  for (int i = 0; i < 10; i++) {
+    queue.Push(i);
+  }
+  EXPECT_FALSE(queue.Empty());
+  int value;
+  for (int i = 0; i < 10; i++) {
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.Pop(value));
+  EXPECT_TRUE(queue.Empty());
+}
+
+// 多个生产者并发写入：不丢失元素，且每个生产者自己的顺序保持不变
+TEST(MpscQueueTest, ManyProducersKeepPerProducerOrder) {
+  const int kProducers = 4;
+  const int kPerProducer = 20000;
+  MpscQueue<std::pair<int, int>> queue;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < kPerProducer; i++) {
+        queue.Push({p, i});
+      }
+    });
+  }
+
+  std::vector<int> next(kProducers, 0);
+  int received = 0;
+  std::pair<int, int> value;
+  while (received < kProducers * kPerProducer) {
+    if (queue.Pop(value)) {
+      ASSERT_EQ(value.second, next[value.first]);
+      next[value.first]++;
+      received++;
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(MpscQueueTest, DestructorFreesRemainingValues) {
+  auto counter = std::make_shared<int>(0);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.Push(counter);
+    queue.Push(counter);
+    EXPECT_EQ(counter.use_count(), 3);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+struct Item : MpscNode {
+  int producer = 0;
+  int index = 0;
+};
+
+TEST(IntrusiveMpscQueueTest, FifoSingleThreadAndReuse) {
+  IntrusiveMpscQueue<Item> queue;
+  Item items[10];
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.Pop(), nullptr);
+  // Twice: a popped node may be pushed again.
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < 10; i++) {
+      items[i].index = i;
+      queue.Push(&items[i]);
+    }
+    EXPECT_FALSE(queue.Empty());
+    for (int i = 0; i < 10; i++) {
+      Item* item = queue.Pop();
+      ASSERT_NE(item, nullptr);
+      EXPECT_EQ(item->index, i);
+    }
+    EXPECT_EQ(queue.Pop(), nullptr);
+    EXPECT_TRUE(queue.Empty());
+  }
+}
+
+TEST(IntrusiveMpscQueueTest, ManyProducersKeepPerProducerOrder) {
+  const int kProducers = 4;
+  const int kPerProducer = 20000;
+  IntrusiveMpscQueue<Item> queue;
+  std::vector<Item> items(kProducers * kPerProducer);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.emplace_back([&queue, &items, p] {
+      for (int i = 0; i < kPerProducer; i++) {
+        Item& item = items[p * kPerProducer + i];
+        item.producer = p;
+        item.index = i;
+        queue.Push(&item);
+      }
+    });
+  }
+
+  std::vector<int> next(kProducers, 0);
+  int received = 0;
+  while (received < kProducers * kPerProducer) {
+    if (Item* item = queue.Pop()) {
+      ASSERT_EQ(item->index, next[item->producer]);
+      next[item->producer]++;
+      received++;
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+// 其他线程投递的任务在EventLoop线程中按顺序执行，并能唤醒阻塞中的循环
+TEST(EventLoopTaskTest, CrossThreadPostsRunInLoopThread) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+
+  const int kPosters = 3;
+  const int kPerPoster = 5000;
+  std::atomic<int> ran{0};
+  std::atomic<bool> wrong_thread{false};
+  std::promise<void> finished;
+
+  std::vector<std::thread> posters;
+  for (int p = 0; p < kPosters; p++) {
+    posters.emplace_back([&] {
+      for (int i = 0; i < kPerPoster; i++) {
+        loop->QueueInLoop([&] {
+          if (!loop->IsInLoopThread()) {
+            wrong_thread = true;
+          }
+          if (++ran == kPosters * kPerPoster) {
+            finished.set_value();
+          }
+        });
+      }
+    });
+  }
+  for (auto& poster : posters) {
+    poster.join();
+  }
+  finished.get_future().wait();
+  EXPECT_FALSE(wrong_thread);
+
+  // A single post to an idle, blocked loop still wakes it.
+  std::promise<void> woken;
+  loop->RunInLoop([&woken] { woken.set_value(); });
+  woken.get_future().wait();
+
+  loop_thread.StopLoop();
+}
+
+TEST(EventLoopTaskTest, TaskQueuedFromTaskRuns) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  std::promise<void> finished;
+  loop->QueueInLoop([&] {
+    loop->QueueInLoop([&finished] { finished.set_value(); });
+  });
+  finished.get_future().wait();
+  loop_thread.StopLoop();
+}
+
+class CountingTask : public LoopTask {
+ public:
+  explicit CountingTask(EventLoop* loop) : loop_(loop) {}
+
+  void RunTask() override {
+    if (!loop_->IsInLoopThread()) {
+      wrong_thread = true;
+    }
+    ran++;
+  }
+
+  std::atomic<int> ran{0};
+  std::atomic<bool> wrong_thread{false};
+
+ private:
+  EventLoop* loop_;
+};
+
+// 同一个任务对象运行后可以再次投递
+TEST(EventLoopTaskTest, PostedTaskRunsInLoopThread) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  CountingTask task(loop);
+  std::thread poster([loop, &task] {
+    for (int i = 0; i < 50; i++) {
+      loop->QueueInLoop(&task);
+      while (task.ran <= i) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  poster.join();
+  loop_thread.StopLoop();
+  EXPECT_EQ(task.ran, 50);
+  EXPECT_FALSE(task.wrong_thread);
+}
+
+TEST(EventLoopTimerTest, RunEveryRepeatsInLoopThread) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  std::atomic<int> fired{0};
+  std::atomic<bool> wrong_thread{false};
+  std::promise<void> finished;
+  loop->RunInLoop([&] {
+    loop->RunEvery(5, [&] {
+      if (!loop->IsInLoopThread()) {
+        wrong_thread = true;
+      }
+      if (++fired == 3) {
+        finished.set_value();
+      }
+    });
+  });
+  finished.get_future().wait();
+  loop_thread.StopLoop();
+  EXPECT_FALSE(wrong_thread);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "../src/core/net/event_loop_thread.h"
+#include "../src/core/rpc/response_closure.h"
+#include "echo_service.pb.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void RunInLoopAndWait(EventLoop* loop, const std::function<void()>& task) {
+  std::promise<void> done;
+  loop->RunInLoop([&task, &done] {
+    task();
+    done.set_value();
+  });
+  done.get_future().wait();
+}
+
+// fds[0]为非阻塞的服务端一侧，fds[1]为阻塞的对端
+void ConnectedPair(int fds[2]) {
+  int listenfd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+  ASSERT_EQ(bind(listenfd, reinterpret_cast<sockaddr*>(&address),
+                 sizeof(address)),
+            0);
+  ASSERT_EQ(listen(listenfd, 1), 0);
+  socklen_t len = sizeof(address);
+  getsockname(listenfd, reinterpret_cast<sockaddr*>(&address), &len);
+  fds[1] = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  ASSERT_EQ(connect(fds[1], reinterpret_cast<sockaddr*>(&address),
+                    sizeof(address)),
+            0);
+  fds[0] = accept4(listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  ASSERT_GE(fds[0], 0);
+  close(listenfd);
+}
+
+// 读取一个v1帧的负载
+std::string ReadFrame(int fd) {
+  int size = 0;
+  if (recv(fd, &size, Codec::kHeaderSize, MSG_WAITALL) != Codec::kHeaderSize) {
+    return {};
+  }
+  std::string payload(size, '\0');
+  if (recv(fd, payload.data(), size, MSG_WAITALL) != size) {
+    return {};
+  }
+  return payload;
+}
+
+void IgnoreMessage(const std::shared_ptr<TcpConnection>&, const FrameHeader&,
+                   const IoBuf&) {}
+
+ResponseClosure* AcquireEcho(const std::shared_ptr<TcpConnection>& connection,
+                             uint32_t id) {
+  return ResponseClosure::Acquire(connection, id, 0,
+                                  rpc::EchoRequest::default_instance(),
+                                  rpc::EchoResponse::default_instance());
+}
+
+class ResponseClosureTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    loop_ = loop_thread_.StartLoop();
+    ASSERT_NO_FATAL_FAILURE(ConnectedPair(fds_));
+    RunInLoopAndWait(loop_, [this] {
+      connection_ =
+          std::make_shared<TcpConnection>(loop_, fds_[0], IgnoreMessage);
+    });
+  }
+
+  void TearDown() override {
+    RunInLoopAndWait(loop_, [this] { connection_.reset(); });
+    close(fds_[1]);
+  }
+
+  EventLoopThread loop_thread_;
+  EventLoop* loop_ = nullptr;
+  int fds_[2] = {-1, -1};
+  std::shared_ptr<TcpConnection> connection_;
+};
+
+}  // namespace
+
+// 在其他线程调用Run()：响应回到loop线程发送，closure随后回到该线程的缓存池并被复用
+TEST_F(ResponseClosureTest, RunFromOtherThreadSendsInLoopAndRecycles) {
+  ResponseClosure* closure = nullptr;
+  size_t pooled = 0;
+  RunInLoopAndWait(loop_, [&] {
+    closure = AcquireEcho(connection_, 7);
+    pooled = ResponseClosure::pooled_count();
+  });
+  static_cast<rpc::EchoResponse*>(closure->response())->set_result("deferred");
+
+  // 先让loop线程阻塞，Run()所在的线程不能自己写socket
+  std::promise<void> gate;
+  std::shared_future<void> opened = gate.get_future().share();
+  loop_->RunInLoop([opened] { opened.wait(); });
+  std::thread([closure] { closure->Run(); }).join();
+
+  char byte;
+  EXPECT_EQ(recv(fds_[1], &byte, 1, MSG_DONTWAIT | MSG_PEEK), -1);
+  EXPECT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+  gate.set_value();
+
+  rpc::RpcMessage message;
+  ASSERT_TRUE(message.ParseFromString(ReadFrame(fds_[1])));
+  EXPECT_EQ(message.id(), 7u);
+  EXPECT_EQ(message.type(), rpc::RPC_TYPE_RESPONSE);
+  rpc::EchoResponse response;
+  ASSERT_TRUE(response.ParseFromString(message.response()));
+  EXPECT_EQ(response.result(), "deferred");
+
+  RunInLoopAndWait(loop_, [&] {
+    EXPECT_EQ(ResponseClosure::pooled_count(), pooled + 1);
+    ResponseClosure* reused = AcquireEcho(connection_, 8);
+    EXPECT_EQ(reused, closure);
+    // 复用的消息已被清空
+    EXPECT_TRUE(
+        static_cast<rpc::EchoResponse*>(reused->response())->result().empty());
+    reused->Release();
+  });
+}
+
+// 占用内存超过64KB的消息不随closure缓存
+TEST_F(ResponseClosureTest, LargeMessagesAreNotPooled) {
+  RunInLoopAndWait(loop_, [&] {
+    size_t bytes = ResponseClosure::pooled_bytes();
+    ResponseClosure* closure = AcquireEcho(connection_, 1);
+    static_cast<rpc::EchoResponse*>(closure->response())
+        ->set_result(std::string(256 * 1024, 'x'));
+    closure->Release();
+    EXPECT_LT(ResponseClosure::pooled_bytes(), bytes + 64 * 1024);
+
+    ResponseClosure* reused = AcquireEcho(connection_, 2);
+    EXPECT_EQ(reused, closure);
+    EXPECT_LT(reused->response()->SpaceUsedLong(), 64 * 1024u);
+    reused->Release();
+  });
+}
+
+// 缓存池保留的消息内存总量不超过16MB
+TEST_F(ResponseClosureTest, PooledBytesAreBounded) {
+  const size_t kMaxPooledBytes = 16 * 1024 * 1024;
+  const int kClosures = 400;
+  RunInLoopAndWait(loop_, [&] {
+    std::vector<ResponseClosure*> closures;
+    for (int i = 0; i < kClosures; i++) {
+      ResponseClosure* closure = AcquireEcho(connection_, i);
+      // 单个不超过64KB，全部缓存则超过上限
+      static_cast<rpc::EchoResponse*>(closure->response())
+          ->set_result(std::string(60 * 1024, 'x'));
+      closures.push_back(closure);
+    }
+    for (ResponseClosure* closure : closures) {
+      closure->Release();
+    }
+    EXPECT_LE(ResponseClosure::pooled_bytes(), kMaxPooledBytes);
+    EXPECT_GT(ResponseClosure::pooled_bytes(), kMaxPooledBytes / 2);
+    EXPECT_LT(ResponseClosure::pooled_count(), static_cast<size_t>(kClosures));
+  });
+}
@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "../include/photonrpc/rpc.h"
+#include "../src/core/common/config.h"
+#include "../src/core/net/codec.h"
+#include "calculate_service.pb.h"
+#include "echo_service.pb.h"
+#include "photonrpc/rpc_message.pb.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class EchoServiceImpl : public rpc::EchoService {
+ public:
+  void Echo(google::protobuf::RpcController* controller,
+            const rpc::EchoRequest* request, rpc::EchoResponse* response,
+            google::protobuf::Closure* done) override {
+    response->set_result(request->sentence());
+    done->Run();
+  }
+};
+
+class CalculateServiceImpl : public rpc::CalculateService {
+ public:
+  void Add(google::protobuf::RpcController* controller,
+           const rpc::AddRequest* request, rpc::AddResponse* response,
+           google::protobuf::Closure* done) override {
+    response->set_result(request->a() + request->b());
+    done->Run();
+  }
+};
+
+// 测试不读取配置文件，服务端和客户端用到的配置在这里给出。
+// 每个测试使用不同的端口，上一个服务端的监听socket不会影响下一个。
+void Configure(int port) {
+  Config& config = Config::GetInstance();
+  config.Set("server", "host", "127.0.0.1");
+  config.Set("server", "port", std::to_string(port));
+  config.Set("server", "io_thread_num", "2");
+  config.Set("server", "listen_mode", "single");
+  config.Set("server", "method_handshake", "false");
+  config.Set("log", "level", "6");
+  config.Set("log", "queue_size", "1024");
+  config.Set("log", "thread_num", "1");
+  config.Set("log", "file_path", "logs/test_rpc_server.log");
+}
+
+bool CanConnect(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+  bool connected =
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+  close(fd);
+  return connected;
+}
+
+bool WaitForListen(int port) {
+  for (int i = 0; i < 500; i++) {
+    if (CanConnect(port)) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
+
+int Connect(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+  if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+      0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// 按v1帧格式收发一个rpc::RpcMessage
+rpc::RpcMessage RoundTrip(int fd, const rpc::RpcMessage& message) {
+  std::string frame(Codec::kHeaderSize, '\0');
+  std::string data = message.SerializeAsString();
+  int size = static_cast<int>(data.size());
+  memcpy(frame.data(), &size, Codec::kHeaderSize);
+  frame += data;
+  rpc::RpcMessage reply;
+  if (write(fd, frame.data(), frame.size()) !=
+      static_cast<ssize_t>(frame.size())) {
+    return reply;
+  }
+  if (recv(fd, &size, Codec::kHeaderSize, MSG_WAITALL) != Codec::kHeaderSize) {
+    return reply;
+  }
+  data.assign(size, '\0');
+  if (recv(fd, data.data(), size, MSG_WAITALL) == size) {
+    reply.ParseFromString(data);
+  }
+  return reply;
+}
+
+std::string Echo(RpcChannel* channel, const std::string& sentence) {
+  rpc::EchoService_Stub stub(channel);
+  rpc::EchoRequest request;
+  rpc::EchoResponse response;
+  request.set_sentence(sentence);
+  stub.Echo(nullptr, &request, &response, nullptr);
+  return response.result();
+}
+
+}  // namespace
+
+// reuseport模式：每个I/O线程一个监听socket，StartServer()之前不接受连接
+TEST(RpcServerTest, ReusePortListensOnlyOnceStarted) {
+  const int kPort = 23461;
+  Configure(kPort);
+  Config::GetInstance().Set("server", "listen_mode", "reuseport");
+
+  RpcServer server;
+  // 服务注册之前不能有请求被分发
+  EXPECT_FALSE(CanConnect(kPort));
+  EchoServiceImpl echo_service;
+  server.ServiceRegister(&echo_service);
+
+  std::thread server_thread([&server] { server.StartServer(); });
+  ASSERT_TRUE(WaitForListen(kPort));
+
+  // 多条连接分布到各个监听socket上
+  std::vector<std::unique_ptr<RpcChannel>> channels;
+  for (int i = 0; i < 8; i++) {
+    channels.push_back(std::make_unique<RpcChannel>());
+    std::string sentence = "reuseport " + std::to_string(i);
+    EXPECT_EQ(Echo(channels.back().get(), sentence), sentence);
+  }
+
+  server.StopServer();
+  server_thread.join();
+}
+
+// 反复创建和销毁RpcChannel：关闭的fd号会被新连接复用，
+// 旧连接的Channel不能残留在poller中
+TEST(RpcServerTest, ChannelsComeAndGo) {
+  const int kPort = 23462;
+  Configure(kPort);
+
+  RpcServer server;
+  EchoServiceImpl echo_service;
+  server.ServiceRegister(&echo_service);
+  std::thread server_thread([&server] { server.StartServer(); });
+  ASSERT_TRUE(WaitForListen(kPort));
+
+  for (int i = 0; i < 50; i++) {
+    RpcChannel channel;
+    std::string sentence = "channel " + std::to_string(i);
+    ASSERT_EQ(Echo(&channel, sentence), sentence);
+  }
+
+  // 多个线程同时在同一条连接上调用，连接在服务端停止时仍然存在
+  RpcChannel channel;
+  std::vector<std::thread> callers;
+  std::atomic<int> failures{0};
+  for (int t = 0; t < 4; t++) {
+    callers.emplace_back([&channel, &failures, t] {
+      for (int i = 0; i < 200; i++) {
+        std::string sentence =
+            "caller " + std::to_string(t) + " call " + std::to_string(i);
+        if (Echo(&channel, sentence) != sentence) {
+          failures++;
+        }
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(failures, 0);
+  // 连接的缓冲区计入服务端的内存统计
+  EXPECT_GT(server.buffer_bytes(), 0);
+
+  server.StopServer();
+  server_thread.join();
+}
+
+// 握手：服务端按名字分配方法ID，之后按ID调用；未知的ID得到错误回复
+TEST(RpcServerTest, HandshakeAssignsMethodIds) {
+  const int kPort = 23463;
+  Configure(kPort);
+
+  RpcServer server;
+  EchoServiceImpl echo_service;
+  server.ServiceRegister(&echo_service);
+  std::thread server_thread([&server] { server.StartServer(); });
+  ASSERT_TRUE(WaitForListen(kPort));
+
+  int fd = Connect(kPort);
+  ASSERT_GE(fd, 0);
+  rpc::HandshakeRequest handshake;
+  handshake.add_method_names("rpc.EchoService.Echo");
+  handshake.add_method_names("rpc.EchoService.Unknown");
+  rpc::RpcMessage message;
+  message.set_id(1);
+  message.set_type(rpc::RPC_TYPE_HANDSHAKE);
+  message.set_request(handshake.SerializeAsString());
+  rpc::RpcMessage reply = RoundTrip(fd, message);
+  EXPECT_EQ(reply.type(), rpc::RPC_TYPE_HANDSHAKE);
+  rpc::HandshakeResponse ids;
+  ASSERT_TRUE(ids.ParseFromString(reply.response()));
+  ASSERT_EQ(ids.method_ids_size(), 2);
+  EXPECT_EQ(ids.method_ids(1), 0xffffffffu);
+
+  rpc::EchoRequest request;
+  request.set_sentence("by id");
+  message.Clear();
+  message.set_id(2);
+  message.set_type(rpc::RPC_TYPE_REQUEST);
+  message.set_method_id(ids.method_ids(0));
+  message.set_request(request.SerializeAsString());
+  reply = RoundTrip(fd, message);
+  EXPECT_EQ(reply.id(), 2u);
+  EXPECT_EQ(reply.type(), rpc::RPC_TYPE_RESPONSE);
+  rpc::EchoResponse response;
+  ASSERT_TRUE(response.ParseFromString(reply.response()));
+  EXPECT_EQ(response.result(), "by id");
+
+  message.set_id(3);
+  message.set_method_id(ids.method_ids(0) + 100);
+  reply = RoundTrip(fd, message);
+  EXPECT_EQ(reply.id(), 3u);
+  EXPECT_EQ(reply.type(), rpc::RPC_TYPE_ERROR);
+  close(fd);
+
+  server.StopServer();
+  server_thread.join();
+}
+
+// 客户端开启握手：先按名字调用并协商ID，之后按ID调用。
+// 服务端重启后同一ID对应另一个方法，旧ID作废，调用按名字进行并重新协商
+TEST(RpcServerTest, HandshakeClientFallsBackToNamesOnNewServer) {
+  const int kPort = 23464;
+  Configure(kPort);
+  Config::GetInstance().Set("server", "method_handshake", "true");
+
+  EchoServiceImpl echo_service;
+  CalculateServiceImpl calculate_service;
+  RpcChannel channel;
+  {
+    // rpc.EchoService.Echo的ID为0
+    RpcServer server;
+    server.ServiceRegister(&echo_service);
+    server.ServiceRegister(&calculate_service);
+    std::thread server_thread([&server] { server.StartServer(); });
+    ASSERT_TRUE(WaitForListen(kPort));
+
+    for (int i = 0; i < 5; i++) {
+      std::string sentence = "first server " + std::to_string(i);
+      EXPECT_EQ(Echo(&channel, sentence), sentence);
+    }
+    server.StopServer();
+    server_thread.join();
+  }
+  // 等客户端处理连接关闭
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  {
+    // ID 0现在是rpc.CalculateService.Add
+    RpcServer server;
+    server.ServiceRegister(&calculate_service);
+    server.ServiceRegister(&echo_service);
+    std::thread server_thread([&server] { server.StartServer(); });
+    ASSERT_TRUE(WaitForListen(kPort));
+
+    for (int i = 0; i < 5; i++) {
+      std::string sentence = "second server " + std::to_string(i);
+      EXPECT_EQ(Echo(&channel, sentence), sentence);
+    }
+    rpc::CalculateService_Stub stub(&channel);
+    rpc::AddRequest request;
+    rpc::AddResponse response;
+    request.set_a(2);
+    request.set_b(3);
+    stub.Add(nullptr, &request, &response, nullptr);
+    EXPECT_EQ(response.result(), 5);
+
+    server.StopServer();
+    server_thread.join();
+  }
+}
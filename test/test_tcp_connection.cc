@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+#include "../src/core/common/config.h"
+#include "../src/core/net/event_loop_thread.h"
+#include "../src/core/net/tcp_connection.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace {
+
+// 连接在第一次创建时缓存这些配置，所以在所有测试之前给出
+const bool configured = [] {
+  Config::GetInstance().Set("server", "max_frame_size", "65536");
+  Config::GetInstance().Set("buffer", "chain_threshold", "4096");
+  return true;
+}();
+
+// 在loop线程中执行并等待完成，TcpConnection只能在其loop线程中访问
+void RunInLoopAndWait(EventLoop* loop, const std::function<void()>& task) {
+  std::promise<void> done;
+  loop->RunInLoop([&task, &done] {
+    task();
+    done.set_value();
+  });
+  done.get_future().wait();
+}
+
+// 建立一条回环TCP连接：fds[0]为非阻塞的服务端一侧，交给TcpConnection；
+// fds[1]为阻塞的对端，由测试线程读写。对端的接收缓冲区为rcvbuf（0为默认）。
+void ConnectedPair(int fds[2], int rcvbuf = 0) {
+  int listenfd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = 0;
+  inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+  ASSERT_EQ(bind(listenfd, reinterpret_cast<sockaddr*>(&address),
+                 sizeof(address)),
+            0);
+  ASSERT_EQ(listen(listenfd, 1), 0);
+  socklen_t len = sizeof(address);
+  getsockname(listenfd, reinterpret_cast<sockaddr*>(&address), &len);
+
+  fds[1] = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (rcvbuf > 0) {
+    setsockopt(fds[1], SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  }
+  ASSERT_EQ(connect(fds[1], reinterpret_cast<sockaddr*>(&address),
+                    sizeof(address)),
+            0);
+  fds[0] = accept4(listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  ASSERT_GE(fds[0], 0);
+  close(listenfd);
+}
+
+std::string ReadExactly(int fd, size_t size) {
+  std::string data(size, '\0');
+  size_t received = 0;
+  while (received < size) {
+    ssize_t n = read(fd, data.data() + received, size - received);
+    if (n <= 0) {
+      break;
+    }
+    received += n;
+  }
+  data.resize(received);
+  return data;
+}
+
+void IgnoreMessage(const std::shared_ptr<TcpConnection>&, const FrameHeader&,
+                   const IoBuf&) {}
+
+}  // namespace
+
+// 对端不读时只写出一部分：剩余数据留在输出缓冲区并注册EPOLLOUT，
+// 对端读完后全部写出，EPOLLOUT随即注销
+TEST(TcpConnectionTest, PartialWriteArmsAndDisarmsEpollout) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  int fds[2];
+  ASSERT_NO_FATAL_FAILURE(ConnectedPair(fds, 4096));
+  int sndbuf = 4096;
+  setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+
+  const size_t kMessageSize = 1 << 20;
+  std::string message(kMessageSize, '\0');
+  for (size_t i = 0; i < kMessageSize; i++) {
+    message[i] = static_cast<char>(i % 251);
+  }
+
+  std::shared_ptr<TcpConnection> connection;
+  size_t pending = 0;
+  bool writing = false;
+  RunInLoopAndWait(loop, [&] {
+    connection = std::make_shared<TcpConnection>(loop, fds[0], IgnoreMessage);
+    std::string copy = message;
+    connection->Send(copy);
+    pending = connection->PendingOutput();
+    writing = connection->IsWriting();
+  });
+  EXPECT_GT(pending, 0u);
+  EXPECT_LT(pending, kMessageSize + Codec::kHeaderSize);
+  EXPECT_TRUE(writing);
+
+  // 对端一直不读，输出保持排队状态
+  usleep(20 * 1000);
+  RunInLoopAndWait(loop, [&] {
+    pending = connection->PendingOutput();
+    writing = connection->IsWriting();
+  });
+  EXPECT_GT(pending, 0u);
+  EXPECT_TRUE(writing);
+
+  std::string received = ReadExactly(fds[1], Codec::kHeaderSize + kMessageSize);
+  ASSERT_EQ(received.size(), Codec::kHeaderSize + kMessageSize);
+  int size;
+  memcpy(&size, received.data(), Codec::kHeaderSize);
+  EXPECT_EQ(size, static_cast<int>(kMessageSize));
+  EXPECT_TRUE(received.compare(Codec::kHeaderSize, kMessageSize, message) == 0);
+
+  // 最后一次写出发生在对端收到数据之前，同时注销了EPOLLOUT
+  RunInLoopAndWait(loop, [&] {
+    pending = connection->PendingOutput();
+    writing = connection->IsWriting();
+  });
+  EXPECT_EQ(pending, 0u);
+  EXPECT_FALSE(writing);
+
+  // 之后的小消息直接写出，不再注册EPOLLOUT
+  RunInLoopAndWait(loop, [&] {
+    std::string small = "ok";
+    connection->Send(small);
+    pending = connection->PendingOutput();
+    writing = connection->IsWriting();
+  });
+  EXPECT_EQ(pending, 0u);
+  EXPECT_FALSE(writing);
+  EXPECT_EQ(ReadExactly(fds[1], Codec::kHeaderSize + 2).substr(Codec::kHeaderSize),
+            "ok");
+
+  RunInLoopAndWait(loop, [&] { connection.reset(); });
+  close(fds[1]);
+}
+
+// 帧长超过max_frame_size时关闭连接；恰好等于上限的帧照常交付
+TEST(TcpConnectionTest, OversizedFrameClosesConnection) {
+  ASSERT_TRUE(configured);
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  int fds[2];
+  ASSERT_NO_FATAL_FAILURE(ConnectedPair(fds));
+
+  const int kMaxFrameSize = 65536;
+  std::promise<size_t> delivered;
+  std::promise<void> closed;
+  std::shared_ptr<TcpConnection> connection;
+  RunInLoopAndWait(loop, [&] {
+    connection = std::make_shared<TcpConnection>(
+        loop, fds[0],
+        [&delivered](const std::shared_ptr<TcpConnection>&, const FrameHeader&,
+                     const IoBuf& message) {
+          delivered.set_value(message.size());
+        });
+    connection->set_close_callback([&closed](Channel*) { closed.set_value(); });
+  });
+
+  // 超过chain_threshold，经由大帧路径读取
+  std::string body(kMaxFrameSize, 'x');
+  std::string frame = Codec::encode(body);
+  ASSERT_EQ(write(fds[1], frame.data(), frame.size()),
+            static_cast<ssize_t>(frame.size()));
+  std::future<size_t> delivered_size = delivered.get_future();
+  ASSERT_EQ(delivered_size.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  EXPECT_EQ(delivered_size.get(), static_cast<size_t>(kMaxFrameSize));
+
+  // 只发出帧头，连接即被关闭
+  int too_long = kMaxFrameSize + 1;
+  ASSERT_EQ(write(fds[1], &too_long, Codec::kHeaderSize), Codec::kHeaderSize);
+  std::future<void> closed_future = closed.get_future();
+  EXPECT_EQ(closed_future.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+
+  RunInLoopAndWait(loop, [&] { connection.reset(); });
+  char byte;
+  EXPECT_EQ(read(fds[1], &byte, 1), 0);
+  close(fds[1]);
+}
+
+// 超过high_water的缓冲区在一个回收周期内用量不足四分之一时收缩
+TEST(TcpConnectionTest, ReclaimShrinksBuffersAboveHighWater) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  int fds[2];
+  ASSERT_NO_FATAL_FAILURE(ConnectedPair(fds));
+
+  std::shared_ptr<TcpConnection> connection;
+  int64_t initial_bytes = 0;
+  RunInLoopAndWait(loop, [&] {
+    connection = std::make_shared<TcpConnection>(loop, fds[0], IgnoreMessage);
+    initial_bytes = loop->buffer_bytes();
+    std::string message(1 << 20, 'x');
+    connection->Send(message);
+  });
+  EXPECT_GT(initial_bytes, 0);
+  ASSERT_EQ(ReadExactly(fds[1], Codec::kHeaderSize + (1 << 20)).size(),
+            Codec::kHeaderSize + (1u << 20));
+  EXPECT_GT(loop->buffer_bytes(), 1 << 20);
+
+  // idle_checks为0：只看high_water
+  RunInLoopAndWait(loop, [&] { connection->ReclaimBuffers(0, 65536); });
+  // 峰值仍在本周期内，不收缩
+  EXPECT_GT(loop->buffer_bytes(), 1 << 20);
+  RunInLoopAndWait(loop, [&] { connection->ReclaimBuffers(0, 65536); });
+  EXPECT_EQ(loop->buffer_bytes(), initial_bytes);
+
+  RunInLoopAndWait(loop, [&] { connection.reset(); });
+  EXPECT_EQ(loop->buffer_bytes(), 0);
+  close(fds[1]);
+}
+
+// 连续idle_checks个周期没有读写时，两个缓冲区都回到初始大小
+TEST(TcpConnectionTest, ReclaimShrinksIdleBuffers) {
+  EventLoopThread loop_thread;
+  EventLoop* loop = loop_thread.StartLoop();
+  int fds[2];
+  ASSERT_NO_FATAL_FAILURE(ConnectedPair(fds));
+
+  std::shared_ptr<TcpConnection> connection;
+  int64_t initial_bytes = 0;
+  auto send = [&](size_t size) {
+    RunInLoopAndWait(loop, [&] {
+      std::string message(size, 'x');
+      connection->Send(message);
+    });
+    ASSERT_EQ(ReadExactly(fds[1], Codec::kHeaderSize + size).size(),
+              Codec::kHeaderSize + size);
+  };
+  // high_water足够大，只看空闲
+  auto reclaim = [&] {
+    RunInLoopAndWait(loop, [&] { connection->ReclaimBuffers(2, 1 << 30); });
+  };
+  RunInLoopAndWait(loop, [&] {
+    connection = std::make_shared<TcpConnection>(loop, fds[0], IgnoreMessage);
+    initial_bytes = loop->buffer_bytes();
+  });
+  send(256 * 1024);
+  int64_t grown_bytes = loop->buffer_bytes();
+  EXPECT_GT(grown_bytes, initial_bytes);
+
+  reclaim();  // 本周期有写出
+  reclaim();  // 空闲1个周期
+  EXPECT_EQ(loop->buffer_bytes(), grown_bytes);
+  // 有读写时重新计数
+  send(16);
+  reclaim();
+  reclaim();
+  EXPECT_EQ(loop->buffer_bytes(), grown_bytes);
+  reclaim();  // 空闲2个周期
+  EXPECT_EQ(loop->buffer_bytes(), initial_bytes);
+
+  RunInLoopAndWait(loop, [&] { connection.reset(); });
+  close(fds[1]);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "../src/core/common/work_stealing_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingPoolTest, RunsAllTasks) {
+  std::atomic<int> sum{0};
+  {
+    WorkStealingPool pool(4);
+    pool.Start();
+    for (int i = 1; i <= 1000; i++) {
+      pool.Submit([&sum, i] { sum += i; });
+    }
+  }  // Stop() drains the queues.
+  EXPECT_EQ(sum, 500500);
+}
+
+TEST(WorkStealingPoolTest, NestedSubmitFromWorker) {
+  WorkStealingPool pool(2);
+  pool.Start();
+  std::promise<int> result;
+  pool.Submit([&pool, &result] {
+    pool.Submit([&result] { result.set_value(42); });
+  });
+  EXPECT_EQ(result.get_future().get(), 42);
+}
+
+// 外部提交的任务按提交顺序执行，工作线程自己提交的任务后进先出
+TEST(WorkStealingPoolTest, SubmittedTasksRunInOrder) {
+  std::vector<int> order;
+  {
+    WorkStealingPool pool(1);
+    pool.Start();
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    pool.Submit([&] {
+      for (int i = 10; i < 13; i++) {
+        pool.Submit([&order, i] { order.push_back(i); });
+      }
+      released.wait();
+    });
+    for (int i = 0; i < 5; i++) {
+      pool.Submit([&order, i] { order.push_back(i); });
+    }
+    release.set_value();
+  }
+  EXPECT_EQ(order, (std::vector<int>{12, 11, 10, 0, 1, 2, 3, 4}));
+}
+
+// 一个工作线程被慢任务占住时，它队列中的任务会被其他线程偷走
+TEST(WorkStealingPoolTest, IdleWorkersStealFromBusyOne) {
+  WorkStealingPool pool(2);
+  pool.Start();
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<void> blocked;
+  std::promise<std::thread::id> first_id;
+  pool.Submit([&] {
+    first_id.set_value(std::this_thread::get_id());
+    // Queued on this worker's own deque, behind the blocking task.
+    pool.Submit([&] { blocked.set_value(); });
+    released.wait();
+  });
+
+  std::thread::id busy = first_id.get_future().get();
+  auto stolen = blocked.get_future();
+  EXPECT_EQ(stolen.wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+  release.set_value();
+  EXPECT_NE(busy, std::thread::id());
+}
+
+TEST(WorkStealingPoolTest, UsesSeveralThreads) {
+  std::mutex mutex;
+  std::set<std::thread::id> ids;
+  {
+    WorkStealingPool pool(3);
+    pool.Start();
+    for (int i = 0; i < 30; i++) {
+      pool.Submit([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.insert(std::this_thread::get_id());
+      });
+    }
+  }
+  EXPECT_GT(ids.size(), 1u);
+}